@@ -0,0 +1,62 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef BALLISTIC_H_
+#define BALLISTIC_H_
+
+#include "types.h"
+
+/*
+* Drag-free radial motion under inverse-square gravity, consistent with
+* CalculateGravity. Integrated with a fourth order Runge-Kutta step in double
+* precision, since the geocentric radius does not fit a float to the metre.
+*/
+inline void BallisticStep(float &asl, float &vel, float h)
+{
+    const double mu = (double)g_0 * earth_radius * earth_radius;
+
+    double r = (double)earth_radius + asl;
+    double v = vel;
+
+    double k1r = v;
+    double k1v = -mu / (r * r);
+
+    double r2 = r + k1r * h / 2;
+    double k2r = v + k1v * h / 2;
+    double k2v = -mu / (r2 * r2);
+
+    double r3 = r + k2r * h / 2;
+    double k3r = v + k2v * h / 2;
+    double k3v = -mu / (r3 * r3);
+
+    double r4 = r + k3r * h;
+    double k4r = v + k3v * h;
+    double k4v = -mu / (r4 * r4);
+
+    r += h * (k1r + 2 * k2r + 2 * k3r + k4r) / 6;
+    v += h * (k1v + 2 * k2v + 2 * k3v + k4v) / 6;
+
+    asl = (float)(r - earth_radius);
+    vel = (float)v;
+}
+
+#endif
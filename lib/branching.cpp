@@ -0,0 +1,144 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "branching.h"
+#include "montecarlo.h"
+#include "workstealing.h"
+#include <algorithm>
+
+// Whether the run has reached the event
+static bool Reached(const System &s, FlightEventType event)
+{
+    for (size_t i = 0; i < s.events.size(); i++)
+    {
+        if (s.events[i].type == event)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+TrajectoryBranching::TrajectoryBranching(const Params &_prefix)
+{
+    prefix = _prefix;
+    forked = false;
+    utilisation = 0.0;
+}
+
+bool TrajectoryBranching::Fork(FlightEventType event)
+{
+    Params p = prefix;
+    p.sim.recordOutput = false;
+    p.sim.streamOutput = false;
+    p.sim.printSummary = false;
+
+    System s(p);
+    s.Begin();
+
+    // Branches replay the step that reaches the event, so they see it too
+    forked = false;
+    fork = s.Snapshot();
+
+    while (!Reached(s, event))
+    {
+        fork = s.Snapshot();
+
+        if (!s.Step())
+        {
+            return false;
+        }
+    }
+
+    forked = true;
+
+    return true;
+}
+
+const SystemSnapshot &TrajectoryBranching::Snapshot() const
+{
+    return fork;
+}
+
+FlightSummary TrajectoryBranching::Continue(const Params &branch) const
+{
+    System s(branch);
+    s.Restore(fork);
+
+    while (s.Step())
+    {
+    }
+
+    return s.summary;
+}
+
+std::vector<FlightSummary> TrajectoryBranching::Continue(const std::vector<Params> &branches, int threads)
+{
+    std::vector<FlightSummary> summaries(branches.size());
+    WorkStealingScheduler scheduler(std::max(threads, 0));
+
+    for (size_t i = 0; i < branches.size(); i++)
+    {
+        // Restored on the first slice, so only branches in progress hold a System
+        std::shared_ptr<System> s;
+        const Params *branch = &branches[i];
+        FlightSummary *summary = &summaries[i];
+        const SystemSnapshot *snapshot = &fork;
+
+        scheduler.Submit([branch, summary, snapshot, s]() mutable
+        {
+            if (!s)
+            {
+                s = std::make_shared<System>(*branch);
+                s->Restore(*snapshot);
+            }
+
+            for (int k = 0; k < MonteCarloRunner::checkpoint_steps; k++)
+            {
+                if (!s->Step())
+                {
+                    *summary = s->summary;
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    scheduler.Run();
+    utilisation = scheduler.Utilisation();
+
+    return summaries;
+}
+
+double TrajectoryBranching::Utilisation() const
+{
+    return utilisation;
+}
+
+TrajectoryBranching::~TrajectoryBranching()
+{
+}
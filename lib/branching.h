@@ -0,0 +1,67 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef BRANCHING_H_
+#define BRANCHING_H_
+
+#include <vector>
+#include "types.h"
+#include "system.h"
+#include "flightsummary.h"
+
+/*
+* Many continuations of one flight that share everything up to an event,
+* such as runs that only differ in recovery settings sharing the powered
+* ascent. The prefix is simulated once and snapshotted at the start of the
+* step that reaches the event, then each branch is restored from the
+* snapshot with its own parameters and run to landing. Branch parameters
+* must only differ in what has not acted before the fork.
+*/
+class TrajectoryBranching
+{
+private:
+    Params prefix;
+    SystemSnapshot fork;
+    bool forked;
+    double utilisation;
+
+public:
+    TrajectoryBranching(const Params &_prefix);
+
+    // Run the prefix up to the event, false if it landed without reaching it
+    bool Fork(FlightEventType event);
+    const SystemSnapshot &Snapshot() const;
+
+    // Continue one branch from the fork
+    FlightSummary Continue(const Params &branch) const;
+    // Continue every branch on a work-stealing scheduler
+    std::vector<FlightSummary> Continue(const std::vector<Params> &branches, int threads);
+
+    // Fraction of worker time spent simulating in the last parallel Continue
+    double Utilisation() const;
+
+    ~TrajectoryBranching();
+};
+
+#endif
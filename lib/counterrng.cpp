@@ -0,0 +1,199 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "counterrng.h"
+#include <math.h>
+#include <algorithm>
+
+// Philox4x32 multipliers and Weyl key increments
+static const uint32_t philox_m0 = 0xD2511F53;
+static const uint32_t philox_m1 = 0xCD9E8D57;
+static const uint32_t philox_w0 = 0x9E3779B9;
+static const uint32_t philox_w1 = 0xBB67AE85;
+static const int philox_rounds = 10;
+
+void Philox4x32(const uint32_t key[2], uint32_t ctr[4])
+{
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+
+    for (int r = 0; r < philox_rounds; r++)
+    {
+        uint64_t p0 = (uint64_t)philox_m0 * ctr[0];
+        uint64_t p1 = (uint64_t)philox_m1 * ctr[2];
+
+        uint32_t c0 = (uint32_t)(p1 >> 32) ^ ctr[1] ^ k0;
+        uint32_t c2 = (uint32_t)(p0 >> 32) ^ ctr[3] ^ k1;
+
+        ctr[0] = c0;
+        ctr[1] = (uint32_t)p1;
+        ctr[2] = c2;
+        ctr[3] = (uint32_t)p0;
+
+        k0 += philox_w0;
+        k1 += philox_w1;
+    }
+}
+
+/*
+* Blocks first to first + count of one key and draw, in structure-of-arrays
+* form so the rounds vectorise across blocks. Words are written in order.
+*/
+template <int N>
+static void PhiloxBlocks(const uint32_t key[2], uint32_t first, uint32_t draw, int count, uint32_t *out)
+{
+    uint32_t c0[N], c1[N], c2[N], c3[N];
+
+    for (int i = 0; i < N; i++)
+    {
+        c0[i] = first + i;
+        c1[i] = draw;
+        c2[i] = 0;
+        c3[i] = 0;
+    }
+
+    uint32_t k0 = key[0];
+    uint32_t k1 = key[1];
+
+    for (int r = 0; r < philox_rounds; r++)
+    {
+        for (int i = 0; i < N; i++)
+        {
+            uint64_t p0 = (uint64_t)philox_m0 * c0[i];
+            uint64_t p1 = (uint64_t)philox_m1 * c2[i];
+
+            c0[i] = (uint32_t)(p1 >> 32) ^ c1[i] ^ k0;
+            c1[i] = (uint32_t)p1;
+            c2[i] = (uint32_t)(p0 >> 32) ^ c3[i] ^ k1;
+            c3[i] = (uint32_t)p0;
+        }
+
+        k0 += philox_w0;
+        k1 += philox_w1;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        out[4 * i] = c0[i];
+        out[4 * i + 1] = c1[i];
+        out[4 * i + 2] = c2[i];
+        out[4 * i + 3] = c3[i];
+    }
+}
+
+/*
+* Acklam's rational approximation, relative error below 1.2e-9, which is
+* well past float precision
+*/
+float NormalQuantile(double p)
+{
+    static const double a[6] = {-3.969683028665376e+01, 2.209460984245205e+02, -2.759285104469687e+02,
+                                1.383577518672690e+02, -3.066479806614716e+01, 2.506628277459239e+00};
+    static const double b[5] = {-5.447609879822406e+01, 1.615858368580409e+02, -1.556989798598866e+02,
+                                6.680131188771972e+01, -1.328068155288572e+01};
+    static const double c[6] = {-7.784894002430293e-03, -3.223964580411365e-01, -2.400758277161838e+00,
+                                -2.549732539343734e+00, 4.374664141464968e+00, 2.938163982698783e+00};
+    static const double d[4] = {7.784695709041462e-03, 3.224671290700398e-01, 2.445134137142996e+00,
+                                3.754408661907416e+00};
+    const double p_low = 0.02425;
+
+    if (p < p_low || p > 1 - p_low)
+    {
+        // Tails, symmetric about the median
+        double q = sqrt(-2 * log(p < p_low ? p : 1 - p));
+        double x = (((((c[0] * q + c[1]) * q + c[2]) * q + c[3]) * q + c[4]) * q + c[5]) /
+                   ((((d[0] * q + d[1]) * q + d[2]) * q + d[3]) * q + 1);
+
+        return p < p_low ? x : -x;
+    }
+
+    double q = p - 0.5;
+    double r = q * q;
+
+    return (((((a[0] * r + a[1]) * r + a[2]) * r + a[3]) * r + a[4]) * r + a[5]) * q /
+           (((((b[0] * r + b[1]) * r + b[2]) * r + b[3]) * r + b[4]) * r + 1);
+}
+
+CounterRng::CounterRng(uint32_t _seed)
+{
+    seed = _seed;
+}
+
+uint32_t CounterRng::Bits(uint32_t param, uint32_t run, uint32_t draw) const
+{
+    uint32_t key[2] = {seed, param};
+    uint32_t ctr[4] = {run >> 2, draw, 0, 0};
+
+    Philox4x32(key, ctr);
+
+    return ctr[run & 3];
+}
+
+float CounterRng::Uniform(uint32_t param, uint32_t run, uint32_t draw) const
+{
+    return UniformFromBits(Bits(param, run, draw));
+}
+
+float CounterRng::Normal(uint32_t param, uint32_t run, uint32_t draw) const
+{
+    return NormalQuantile(Uniform(param, run, draw));
+}
+
+void CounterRng::Uniforms(uint32_t param, uint32_t first, int n, float *out, uint32_t draw) const
+{
+    uint32_t key[2] = {seed, param};
+    uint32_t words[4 * batch_blocks];
+
+    int i = 0;
+
+    while (i < n)
+    {
+        uint32_t run = first + i;
+        int offset = run & 3;
+        int count = std::min(n - i, 4 * batch_blocks - offset);
+
+        PhiloxBlocks<batch_blocks>(key, run >> 2, draw, (offset + count + 3) / 4, words);
+
+        for (int k = 0; k < count; k++)
+        {
+            out[i + k] = UniformFromBits(words[offset + k]);
+        }
+
+        i += count;
+    }
+}
+
+void CounterRng::Normals(uint32_t param, uint32_t first, int n, float *out, uint32_t draw) const
+{
+    Uniforms(param, first, n, out, draw);
+
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = NormalQuantile(out[i]);
+    }
+}
+
+CounterRng::~CounterRng()
+{
+}
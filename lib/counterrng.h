@@ -0,0 +1,75 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef COUNTERRNG_H_
+#define COUNTERRNG_H_
+
+#include <stdint.h>
+
+// Philox4x32-10 block function, encrypts ctr in place under key
+void Philox4x32(const uint32_t key[2], uint32_t ctr[4]);
+
+// Standard normal deviate at cumulative probability p in (0, 1)
+float NormalQuantile(double p);
+
+// Top 24 bits on the midpoints of a uniform grid, in the open interval (0, 1)
+inline float UniformFromBits(uint32_t bits)
+{
+    return ((bits >> 8) + 0.5f) * (1.0f / 16777216.0f);
+}
+
+/*
+* Counter-based random numbers for dispersion campaigns. Every draw is a
+* pure function of the campaign seed, the parameter it disperses, the run
+* index and the draw within the run, so any run can be regenerated on its
+* own and results do not depend on which thread drew them or in what order.
+*
+* The key is the seed and parameter id. One Philox block holds the draws of
+* four consecutive runs, so the batch functions, which draw one parameter
+* for a range of runs, use every word of every block.
+*/
+class CounterRng
+{
+private:
+    uint32_t seed;
+
+    static const int batch_blocks = 16;
+
+public:
+    CounterRng(uint32_t _seed);
+
+    uint32_t Bits(uint32_t param, uint32_t run, uint32_t draw = 0) const;
+
+    // Uniform in the open interval (0, 1)
+    float Uniform(uint32_t param, uint32_t run, uint32_t draw = 0) const;
+    float Normal(uint32_t param, uint32_t run, uint32_t draw = 0) const;
+
+    // Draws of param for runs first to first + n, equal to the single draws
+    void Uniforms(uint32_t param, uint32_t first, int n, float *out, uint32_t draw = 0) const;
+    void Normals(uint32_t param, uint32_t first, int n, float *out, uint32_t draw = 0) const;
+
+    ~CounterRng();
+};
+
+#endif
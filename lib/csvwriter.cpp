@@ -0,0 +1,172 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "csvwriter.h"
+#include "recorder.h"
+#include <iostream>
+#include <charconv>
+#include <algorithm>
+
+// Longest float from to_chars, e.g. "-1.17549435e-38", plus the separator
+static const size_t max_value_length = 32;
+
+CsvWriter::CsvWriter()
+{
+    out = nullptr;
+    buffer.resize(buffer_size);
+    used = 0;
+}
+
+CsvWriter::CsvWriter(std::ostream &_out)
+    : CsvWriter()
+{
+    out = &_out;
+}
+
+bool CsvWriter::Open(const std::string &filename)
+{
+    Close();
+
+    file.open(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "Error: Cannot open output file " << filename << std::endl;
+        return false;
+    }
+
+    out = &file;
+
+    return true;
+}
+
+void CsvWriter::Reserve(size_t length)
+{
+    if (used + length > buffer.size())
+    {
+        Flush();
+    }
+
+    if (length > buffer.size())
+    {
+        buffer.resize(length);
+    }
+}
+
+void CsvWriter::WriteHeader(const std::vector<std::string> &names)
+{
+    precision.assign(names.size(), 0);
+
+    for (size_t c = 0; c < names.size(); c++)
+    {
+        Reserve(names[c].size() + 1);
+        names[c].copy(buffer.data() + used, names[c].size());
+        used += names[c].size();
+        buffer[used++] = ',';
+    }
+
+    Reserve(1);
+    buffer[used++] = '\n';
+}
+
+void CsvWriter::SetPrecision(size_t column, int digits)
+{
+    // Nine significant digits already round trip a float, and keep values
+    // within max_value_length
+    if (column < precision.size())
+    {
+        precision[column] = digits > 0 ? std::min(digits, 9) : 0;
+    }
+}
+
+void CsvWriter::SetPrecision(const std::vector<int> &channels, const std::vector<CsvPrecisionParameter> &digits)
+{
+    for (size_t i = 0; i < digits.size(); i++)
+    {
+        int ch = FindChannel(digits[i].channel);
+
+        for (size_t c = 0; c < channels.size(); c++)
+        {
+            if (channels[c] == ch)
+            {
+                SetPrecision(c, digits[i].digits);
+            }
+        }
+    }
+}
+
+void CsvWriter::WriteRow(const float *values)
+{
+    Reserve(precision.size() * max_value_length + 1);
+
+    char *p = buffer.data() + used;
+    char *end = buffer.data() + buffer.size();
+
+    for (size_t c = 0; c < precision.size(); c++)
+    {
+        std::to_chars_result result;
+
+        if (precision[c] > 0)
+        {
+            result = std::to_chars(p, end - 1, values[c], std::chars_format::general, precision[c]);
+        }
+        else
+        {
+            result = std::to_chars(p, end - 1, values[c]);
+        }
+
+        // Leaves the field empty rather than writing past the buffer
+        if (result.ec == std::errc())
+        {
+            p = result.ptr;
+        }
+        *p++ = ',';
+    }
+    *p++ = '\n';
+
+    used = p - buffer.data();
+}
+
+void CsvWriter::Flush()
+{
+    if (out != nullptr && used > 0)
+    {
+        out->write(buffer.data(), used);
+    }
+
+    used = 0;
+}
+
+void CsvWriter::Close()
+{
+    Flush();
+
+    if (file.is_open())
+    {
+        file.close();
+    }
+}
+
+CsvWriter::~CsvWriter()
+{
+    Close();
+}
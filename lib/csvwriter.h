@@ -0,0 +1,78 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef CSVWRITER_H_
+#define CSVWRITER_H_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "types.h"
+
+/*
+* CSV writer for trajectory output. Values are formatted with std::to_chars
+* into a large reusable buffer, which goes to the stream in block writes
+* once full. Each column is written in shortest round trip form unless it
+* has been given a number of significant digits.
+*/
+class CsvWriter
+{
+private:
+    std::ofstream file;
+    std::ostream *out;
+
+    std::vector<char> buffer;
+    size_t used;
+
+    // Significant digits per column, zero for shortest round trip
+    std::vector<int> precision;
+
+    void Reserve(size_t length);
+
+public:
+    static const size_t buffer_size = 1 << 20;
+
+    CsvWriter();
+
+    // Write to an already open stream, such as std::cout
+    CsvWriter(std::ostream &_out);
+
+    bool Open(const std::string &filename);
+
+    // Names also set the column count
+    void WriteHeader(const std::vector<std::string> &names);
+
+    void SetPrecision(size_t column, int digits);
+    // Precision by channel name for columns holding the given channels
+    void SetPrecision(const std::vector<int> &channels, const std::vector<CsvPrecisionParameter> &digits);
+
+    // One value per column
+    void WriteRow(const float *values);
+
+    void Flush();
+    void Close();
+
+    ~CsvWriter();
+};
+
+#endif
@@ -0,0 +1,168 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#include "denseoutput.h"
+#include <math.h>
+#include <algorithm>
+
+DenseOutput::DenseOutput()
+{
+    interval = 0.0f;
+    next_index = 0;
+    next_time = 0.0f;
+    policy = nullptr;
+}
+
+DenseOutput::DenseOutput(float _interval)
+{
+    interval = _interval;
+    next_index = 0;
+    next_time = 0.0f;
+    policy = nullptr;
+}
+
+DenseOutput::DenseOutput(std::vector<float> _times)
+{
+    interval = 0.0f;
+    times = _times;
+    std::sort(times.begin(), times.end());
+    next_index = 0;
+    next_time = times.empty() ? 0.0f : times[0];
+    policy = nullptr;
+}
+
+void DenseOutput::SetPolicy(RecordingPolicy *_policy)
+{
+    policy = _policy;
+}
+
+void DenseOutput::Emit(const SimSample &s, TrajectoryRecorder &output)
+{
+    if (policy)
+    {
+        policy->Offer(s, output);
+    }
+    else
+    {
+        output.Record(s);
+    }
+}
+
+void DenseOutput::Begin(const SimSample &initial, TrajectoryRecorder &output)
+{
+    next_index = 0;
+
+    if (!times.empty())
+    {
+        // Requested times before the start of the run cannot be sampled
+        while (next_index < times.size() && times[next_index] < initial[CH_T])
+        {
+            next_index++;
+        }
+
+        next_time = next_index < times.size() ? times[next_index] : INFINITY;
+    }
+    else if (interval > 0)
+    {
+        next_index = (size_t)ceilf(initial[CH_T] / interval);
+        next_time = next_index * interval;
+    }
+    else
+    {
+        return;
+    }
+
+    if (next_time == initial[CH_T])
+    {
+        Emit(initial, output);
+        NextTime();
+    }
+}
+
+void DenseOutput::Advance(const SimSample &prev, const SimSample &curr, TrajectoryRecorder &output)
+{
+    if (times.empty() && interval <= 0)
+    {
+        Emit(curr, output);
+        return;
+    }
+
+    while (next_time <= curr[CH_T])
+    {
+        Emit(Evaluate(prev, curr, next_time, output.ChannelList()), output);
+        NextTime();
+    }
+}
+
+void DenseOutput::NextTime()
+{
+    next_index++;
+
+    if (!times.empty())
+    {
+        next_time = next_index < times.size() ? times[next_index] : INFINITY;
+    }
+    else
+    {
+        // Multiply rather than accumulate to avoid drift over long flights
+        next_time = next_index * interval;
+    }
+}
+
+SimSample DenseOutput::Evaluate(const SimSample &s0, const SimSample &s1, float tp, const std::vector<int> &channels)
+{
+    float h = s1[CH_T] - s0[CH_T];
+
+    if (h <= 0)
+    {
+        return s1;
+    }
+
+    float s = (tp - s0[CH_T]) / h;
+
+    // Cubic Hermite basis functions
+    float h00 = 2 * s * s * s - 3 * s * s + 1;
+    float h10 = s * s * s - 2 * s * s + s;
+    float h01 = -2 * s * s * s + 3 * s * s;
+    float h11 = s * s * s - s * s;
+
+    SimSample out = s1;
+
+    // Channels vary linearly across the step
+    for (size_t i = 0; i < channels.size(); i++)
+    {
+        int ch = channels[i];
+        out[ch] = Interpolate(s0[CH_T], s1[CH_T], s0[ch], s1[ch], tp);
+    }
+
+    out[CH_T] = tp;
+
+    // Position uses the velocities at both ends of the step, which reproduces
+    // the constant acceleration update exactly and is third order otherwise
+    out[CH_ASL] = h00 * s0[CH_ASL] + h10 * h * s0[CH_VEL] + h01 * s1[CH_ASL] + h11 * h * s1[CH_VEL];
+
+    return out;
+}
+
+DenseOutput::~DenseOutput()
+{
+}
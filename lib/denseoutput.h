@@ -0,0 +1,71 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef DENSEOUTPUT_H_
+#define DENSEOUTPUT_H_
+
+#include <vector>
+#include "types.h"
+#include "recorder.h"
+#include "recordingpolicy.h"
+
+/*
+* Continuous extension of the integrator output. Samples are taken from the
+* interpolant spanning each completed step, so the log rate is independent of
+* the integration step and no additional derivative evaluations are needed.
+*/
+class DenseOutput
+{
+private:
+    // Uniform sample interval, zero records every integration step
+    float interval;
+
+    // Explicit sample times, used in place of the interval when non-empty
+    std::vector<float> times;
+
+    // Next pending sample
+    size_t next_index;
+    float next_time;
+
+    // Optional filter between the interpolant and the recorder
+    RecordingPolicy *policy;
+
+    void NextTime();
+    void Emit(const SimSample &s, TrajectoryRecorder &output);
+    SimSample Evaluate(const SimSample &s0, const SimSample &s1, float tp, const std::vector<int> &channels);
+
+public:
+    DenseOutput();
+
+    DenseOutput(float _interval);
+
+    DenseOutput(std::vector<float> _times);
+
+    void SetPolicy(RecordingPolicy *_policy);
+
+    void Begin(const SimSample &initial, TrajectoryRecorder &output);
+    void Advance(const SimSample &prev, const SimSample &curr, TrajectoryRecorder &output);
+
+    ~DenseOutput();
+};
+
+#endif
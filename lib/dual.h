@@ -0,0 +1,206 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef DUAL_H_
+#define DUAL_H_
+
+#include <math.h>
+
+/*
+* Forward mode automatic differentiation number carrying the value and its
+* partial derivatives with respect to N seeded inputs. Comparisons act on the
+* value only, so branching code follows the same path as the float version.
+*/
+template <int N>
+struct Dual
+{
+    float v;
+    float d[N];
+
+    Dual() : v(0.0f)
+    {
+        for (int i = 0; i < N; i++)
+        {
+            d[i] = 0.0f;
+        }
+    }
+
+    Dual(float _v) : v(_v)
+    {
+        for (int i = 0; i < N; i++)
+        {
+            d[i] = 0.0f;
+        }
+    }
+
+    // Independent variable with unit derivative in slot i
+    static Dual Variable(float _v, int i)
+    {
+        Dual x(_v);
+        x.d[i] = 1.0f;
+        return x;
+    }
+
+    Dual &operator+=(const Dual &b) { *this = *this + b; return *this; }
+    Dual &operator-=(const Dual &b) { *this = *this - b; return *this; }
+    Dual &operator*=(const Dual &b) { *this = *this * b; return *this; }
+    Dual &operator/=(const Dual &b) { *this = *this / b; return *this; }
+};
+
+/*
+* Value of a scalar, with the derivative parts discarded
+*/
+inline float Value(float x)
+{
+    return x;
+}
+
+template <int N>
+inline float Value(const Dual<N> &x)
+{
+    return x.v;
+}
+
+// Derivative chain rule for a unary function with value f and slope df
+template <int N>
+inline Dual<N> Chain(const Dual<N> &a, float f, float df)
+{
+    Dual<N> r(f);
+    for (int i = 0; i < N; i++)
+    {
+        r.d[i] = df * a.d[i];
+    }
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator-(const Dual<N> &a)
+{
+    return Chain(a, -a.v, -1.0f);
+}
+
+template <int N>
+inline Dual<N> operator+(const Dual<N> &a, const Dual<N> &b)
+{
+    Dual<N> r(a.v + b.v);
+    for (int i = 0; i < N; i++)
+    {
+        r.d[i] = a.d[i] + b.d[i];
+    }
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator-(const Dual<N> &a, const Dual<N> &b)
+{
+    Dual<N> r(a.v - b.v);
+    for (int i = 0; i < N; i++)
+    {
+        r.d[i] = a.d[i] - b.d[i];
+    }
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator*(const Dual<N> &a, const Dual<N> &b)
+{
+    Dual<N> r(a.v * b.v);
+    for (int i = 0; i < N; i++)
+    {
+        r.d[i] = a.d[i] * b.v + a.v * b.d[i];
+    }
+    return r;
+}
+
+template <int N>
+inline Dual<N> operator/(const Dual<N> &a, const Dual<N> &b)
+{
+    Dual<N> r(a.v / b.v);
+    for (int i = 0; i < N; i++)
+    {
+        r.d[i] = (a.d[i] * b.v - a.v * b.d[i]) / (b.v * b.v);
+    }
+    return r;
+}
+
+// Mixed float operands
+template <int N> inline Dual<N> operator+(const Dual<N> &a, float b) { return a + Dual<N>(b); }
+template <int N> inline Dual<N> operator+(float a, const Dual<N> &b) { return Dual<N>(a) + b; }
+template <int N> inline Dual<N> operator-(const Dual<N> &a, float b) { return a - Dual<N>(b); }
+template <int N> inline Dual<N> operator-(float a, const Dual<N> &b) { return Dual<N>(a) - b; }
+template <int N> inline Dual<N> operator*(const Dual<N> &a, float b) { return Chain(a, a.v * b, b); }
+template <int N> inline Dual<N> operator*(float a, const Dual<N> &b) { return Chain(b, a * b.v, a); }
+template <int N> inline Dual<N> operator/(const Dual<N> &a, float b) { return Chain(a, a.v / b, 1.0f / b); }
+template <int N> inline Dual<N> operator/(float a, const Dual<N> &b) { return Dual<N>(a) / b; }
+
+// Comparisons on the value
+template <int N> inline bool operator<(const Dual<N> &a, const Dual<N> &b) { return a.v < b.v; }
+template <int N> inline bool operator<=(const Dual<N> &a, const Dual<N> &b) { return a.v <= b.v; }
+template <int N> inline bool operator>(const Dual<N> &a, const Dual<N> &b) { return a.v > b.v; }
+template <int N> inline bool operator>=(const Dual<N> &a, const Dual<N> &b) { return a.v >= b.v; }
+template <int N> inline bool operator<(const Dual<N> &a, float b) { return a.v < b; }
+template <int N> inline bool operator<=(const Dual<N> &a, float b) { return a.v <= b; }
+template <int N> inline bool operator>(const Dual<N> &a, float b) { return a.v > b; }
+template <int N> inline bool operator>=(const Dual<N> &a, float b) { return a.v >= b; }
+template <int N> inline bool operator<(float a, const Dual<N> &b) { return a < b.v; }
+template <int N> inline bool operator<=(float a, const Dual<N> &b) { return a <= b.v; }
+template <int N> inline bool operator>(float a, const Dual<N> &b) { return a > b.v; }
+template <int N> inline bool operator>=(float a, const Dual<N> &b) { return a >= b.v; }
+
+// Elementary functions
+template <int N>
+inline Dual<N> sqrt(const Dual<N> &a)
+{
+    float f = sqrtf(a.v);
+    return Chain(a, f, f > 0 ? 0.5f / f : 0.0f);
+}
+
+template <int N>
+inline Dual<N> exp(const Dual<N> &a)
+{
+    float f = expf(a.v);
+    return Chain(a, f, f);
+}
+
+template <int N>
+inline Dual<N> pow(const Dual<N> &a, float b)
+{
+    float f = powf(a.v, b);
+    return Chain(a, f, a.v != 0 ? b * f / a.v : 0.0f);
+}
+
+template <int N>
+inline Dual<N> fabs(const Dual<N> &a)
+{
+    return a.v < 0 ? -a : a;
+}
+
+// Rounds the value but keeps the slope, so quantised inputs stay differentiable
+template <int N>
+inline Dual<N> round(const Dual<N> &a)
+{
+    Dual<N> r = a;
+    r.v = roundf(a.v);
+    return r;
+}
+
+#endif
@@ -0,0 +1,421 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "ensemble.h"
+#include <math.h>
+
+// Homosphere layer base temperatures, as used by CalculateTemperature
+static const float layer_temp[7] = {288.15f, 216.65f, 216.65f, 228.65f, 270.65f, 270.65f, 214.65f};
+
+// Top of the homosphere in geopotential altitude
+static const float homosphere_top = 84852.0f;
+
+EnvironmentVarsT<EnsembleArray> CalculateEnsembleEnvironment(const EnsembleArray &alt)
+{
+    int n = alt.size();
+    EnvironmentVarsT<EnsembleArray> vars;
+
+    EnsembleArray geo_alt = (earth_radius * alt / (earth_radius + alt)).round();
+    vars.g = g_0 * (earth_radius / (earth_radius + alt)).square();
+
+    const float k = g_0 * air_molar_mass / gas_constant;
+
+    /*
+    * Constants of the layer each lane is in. The barometric formula is
+    * folded into one exponent, k / lapse * log(t_base / temp) in gradient
+    * layers and -k * (geo_alt - alt_base) / t_base in isothermal ones, so
+    * the transcendental work below runs branch free over every lane.
+    */
+    float layer_alt[7];
+    float layer_lapse[7];
+    float layer_pressure[7];
+    float layer_t_base[7];
+    float layer_gradient_k[7];
+    float layer_isothermal_k[7];
+
+    for (int b = 0; b < 7; b++)
+    {
+        layer_alt[b] = hb[b];
+        layer_lapse[b] = lm[b];
+        layer_pressure[b] = pb[b];
+        layer_t_base[b] = tb[b];
+        layer_gradient_k[b] = lm[b] != 0 ? k / lm[b] : 0.0f;
+        layer_isothermal_k[b] = lm[b] != 0 ? 0.0f : -k / tb[b];
+    }
+
+    auto layer = [&](float h)
+    {
+        int b = 0;
+
+        for (int j = 1; j < 7; j++)
+        {
+            b += h > layer_alt[j];
+        }
+
+        return b;
+    };
+
+    EnsembleArray temp_base(n), lapse(n), alt_base(n), p_base(n), t_base(n), gradient_k(n), isothermal_k(n);
+
+    float lowest = geo_alt.minCoeff();
+    float highest = geo_alt.maxCoeff();
+    int b = layer(lowest);
+
+    // Vehicles flying together are usually all in the same layer
+    if (b == layer(highest))
+    {
+        temp_base.setConstant(layer_temp[b]);
+        lapse.setConstant(layer_lapse[b]);
+        alt_base.setConstant(layer_alt[b]);
+        p_base.setConstant(layer_pressure[b]);
+        t_base.setConstant(layer_t_base[b]);
+        gradient_k.setConstant(layer_gradient_k[b]);
+        isothermal_k.setConstant(layer_isothermal_k[b]);
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+        {
+            int b = layer(geo_alt[i]);
+
+            temp_base[i] = layer_temp[b];
+            lapse[i] = layer_lapse[b];
+            alt_base[i] = layer_alt[b];
+            p_base[i] = layer_pressure[b];
+            t_base[i] = layer_t_base[b];
+            gradient_k[i] = layer_gradient_k[b];
+            isothermal_k[i] = layer_isothermal_k[b];
+        }
+    }
+
+    vars.tempFunc.temp = temp_base + lapse * (geo_alt - alt_base);
+    vars.tempFunc.b = 0;
+
+    EnsembleArray exponent = gradient_k * (t_base / vars.tempFunc.temp).log() + isothermal_k * (geo_alt - alt_base);
+
+    vars.pressure = p_base * exponent.exp();
+    vars.density = (vars.pressure * air_molar_mass) / (gas_constant * vars.tempFunc.temp);
+    vars.c = ((air_gamma * gas_constant / air_molar_mass) * vars.tempFunc.temp).sqrt();
+
+    // Rare enough for sounding rockets to fall back to the scalar model
+    if (highest > homosphere_top)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (geo_alt[i] <= homosphere_top)
+            {
+                continue;
+            }
+
+            EnvironmentVars scalar = CalculateEnvironmentVariables(alt[i]);
+
+            vars.g[i] = scalar.g;
+            vars.tempFunc.temp[i] = scalar.tempFunc.temp;
+            vars.pressure[i] = scalar.pressure;
+            vars.density[i] = scalar.density;
+            vars.c[i] = scalar.c;
+        }
+    }
+
+    return vars;
+}
+
+EnsembleArray CalculateEnsembleWind(const EnsembleArray &alt_agl, const EnsembleArray &wind_speed, float exponent)
+{
+    // Power law as exp and log, clamped so lanes on the ground stay finite
+    EnsembleArray wind = wind_speed * (exponent * (alt_agl.max(1e-3f) / 10.0f).log()).exp();
+
+    for (int i = 0; i < wind.size(); i++)
+    {
+        if (alt_agl[i] <= 0)
+        {
+            wind[i] = 0.0f;
+        }
+    }
+
+    return wind;
+}
+
+void CompactLanes(EnsembleArray &a, const std::vector<int> &lanes)
+{
+    for (size_t i = 0; i < lanes.size(); i++)
+    {
+        a[i] = a[lanes[i]];
+    }
+
+    a.conservativeResize(lanes.size());
+}
+
+SingleSolidMotorEnsemble::SingleSolidMotorEnsemble(Params p, ThrustCurve curve, int n)
+    : motor(p, curve)
+{
+    isp = p.engine.isp;
+    burn_time = p.engine.burn_time;
+    cs_area = p.aero.cs_area;
+    elevation = p.env.elevation;
+    wind_exponent = p.env.wind_exponent;
+
+    cd = EnsembleArray::Constant(n, p.aero.cd);
+    dry_mass = EnsembleArray::Constant(n, p.dryMass);
+    thrust_scale = EnsembleArray::Constant(n, 1.0f);
+    wind_speed = EnsembleArray::Constant(n, p.env.wind_speed);
+}
+
+int SingleSolidMotorEnsemble::Size() const
+{
+    return cd.size();
+}
+
+SingleSolidMotorEnsemble::State SingleSolidMotorEnsemble::InitialState() const
+{
+    int n = Size();
+    State s;
+
+    s.t = 0.0f;
+    s.altitude = EnsembleArray::Constant(n, elevation);
+    s.vel = EnsembleArray::Zero(n);
+    s.downrange = EnsembleArray::Zero(n);
+    s.vel_x = EnsembleArray::Zero(n);
+
+    // Scaling thrust at a fixed burn time scales the propellant burnt
+    s.prop_mass = thrust_scale * motor.InitialState().prop_mass;
+
+    return s;
+}
+
+float SingleSolidMotorEnsemble::NextEvent(float t) const
+{
+    return motor.NextEvent(t);
+}
+
+EnsembleMask SingleSolidMotorEnsemble::Landed(const State &s) const
+{
+    if (s.t <= 0)
+    {
+        return EnsembleMask::Constant(Size(), false);
+    }
+
+    return s.altitude < elevation;
+}
+
+float SingleSolidMotorEnsemble::Elevation() const
+{
+    return elevation;
+}
+
+float SingleSolidMotorEnsemble::BurnTime() const
+{
+    return burn_time;
+}
+
+SingleSolidMotorEnsemble::Derivative SingleSolidMotorEnsemble::Evaluate(const State &s) const
+{
+    Derivative d;
+
+    d.vars = CalculateEnsembleEnvironment(s.altitude);
+    d.mass = dry_mass + s.prop_mass;
+    d.thrust = thrust_scale * motor.CalculateThrust(s.t);
+    d.mass_flow_rate = (d.thrust / g_0) / isp;
+
+    EnsembleArray cda = cd * cs_area;
+    EnsembleArray rel_vel = s.vel_x - CalculateEnsembleWind(s.altitude - elevation, wind_speed, wind_exponent);
+    EnsembleArray airspeed = (rel_vel.square() + s.vel.square()).sqrt();
+
+    d.drag = 0.5f * d.vars.density * s.vel * s.vel.abs() * cda;
+    d.vel = s.vel;
+    d.acc = (d.thrust - d.mass * d.vars.g - d.drag) / d.mass;
+    d.vel_x = s.vel_x;
+    d.acc_x = -0.5f * d.vars.density * airspeed * rel_vel * cda / d.mass;
+
+    // Held on the pad until thrust exceeds weight
+    if (s.t < burn_time)
+    {
+        for (int i = 0; i < Size(); i++)
+        {
+            if (s.altitude[i] <= elevation && s.vel[i] <= 0 && d.acc[i] < 0)
+            {
+                d.acc[i] = 0.0f;
+                d.acc_x[i] = 0.0f;
+            }
+        }
+    }
+
+    return d;
+}
+
+SingleSolidMotorEnsemble SingleSolidMotorEnsemble::Block(int first, int count) const
+{
+    SingleSolidMotorEnsemble block = *this;
+
+    block.cd = cd.segment(first, count);
+    block.dry_mass = dry_mass.segment(first, count);
+    block.thrust_scale = thrust_scale.segment(first, count);
+    block.wind_speed = wind_speed.segment(first, count);
+
+    return block;
+}
+
+void SingleSolidMotorEnsemble::Compact(const std::vector<int> &lanes)
+{
+    CompactLanes(cd, lanes);
+    CompactLanes(dry_mass, lanes);
+    CompactLanes(thrust_scale, lanes);
+    CompactLanes(wind_speed, lanes);
+}
+
+EnsembleSummary::EnsembleSummary()
+{
+    Begin(0);
+}
+
+void EnsembleSummary::Begin(int n)
+{
+    apogee = EnsembleArray::Constant(n, -INFINITY);
+    max_vel = EnsembleArray::Constant(n, -INFINITY);
+    max_mach = EnsembleArray::Constant(n, -INFINITY);
+    max_acc = EnsembleArray::Constant(n, -INFINITY);
+    max_q = EnsembleArray::Constant(n, -INFINITY);
+
+    apogee_t = EnsembleArray::Zero(n);
+    max_vel_t = EnsembleArray::Zero(n);
+    max_mach_t = EnsembleArray::Zero(n);
+    max_acc_t = EnsembleArray::Zero(n);
+    max_q_t = EnsembleArray::Zero(n);
+
+    burnt_out = false;
+    burnout_time = 0.0f;
+    burnout_asl = EnsembleArray::Zero(n);
+    burnout_vel = EnsembleArray::Zero(n);
+
+    prev_t = 0.0f;
+    has_prev = false;
+}
+
+// Raise the peak of lane i if it is exceeded
+static inline void Peak(EnsembleArray &peak, EnsembleArray &peak_t, int i, float value, float t)
+{
+    if (value > peak[i])
+    {
+        peak[i] = value;
+        peak_t[i] = t;
+    }
+}
+
+void EnsembleSummary::Update(const PointMassStateT<EnsembleArray> &s, const PointMassDerivativeT<EnsembleArray> &d, const EnsembleMask &active)
+{
+    float h = s.t - prev_t;
+
+    for (int i = 0; i < active.size(); i++)
+    {
+        if (!active[i])
+        {
+            continue;
+        }
+
+        float vel = s.vel[i];
+
+        Peak(apogee, apogee_t, i, s.altitude[i], s.t);
+        Peak(max_vel, max_vel_t, i, vel, s.t);
+        Peak(max_mach, max_mach_t, i, vel / d.vars.c[i], s.t);
+        Peak(max_acc, max_acc_t, i, d.acc[i], s.t);
+        Peak(max_q, max_q_t, i, 0.5f * d.vars.density[i] * vel * vel, s.t);
+
+        // Apogee refined at the velocity zero crossing, as in FlightSummary
+        if (has_prev && prev_vel[i] > 0 && vel <= 0)
+        {
+            float tp = h * prev_vel[i] / (prev_vel[i] - vel);
+
+            Peak(apogee, apogee_t, i, prev_asl[i] + 0.5f * prev_vel[i] * tp, prev_t + tp);
+        }
+    }
+
+    prev_t = s.t;
+    prev_asl = s.altitude;
+    prev_vel = s.vel;
+    has_prev = true;
+}
+
+void EnsembleSummary::OnBurnout(const PointMassStateT<EnsembleArray> &s)
+{
+    burnt_out = true;
+    burnout_time = s.t;
+    burnout_asl = s.altitude;
+    burnout_vel = s.vel;
+}
+
+FlightSummary EnsembleSummary::OnLanding(const PointMassStateT<EnsembleArray> &s, int lane) const
+{
+    FlightSummary summary;
+
+    summary.apogee = SummaryPeak{apogee[lane], apogee_t[lane]};
+    summary.max_vel = SummaryPeak{max_vel[lane], max_vel_t[lane]};
+    summary.max_mach = SummaryPeak{max_mach[lane], max_mach_t[lane]};
+    summary.max_acc = SummaryPeak{max_acc[lane], max_acc_t[lane]};
+    summary.max_q = SummaryPeak{max_q[lane], max_q_t[lane]};
+
+    summary.burnt_out = burnt_out;
+    if (burnt_out)
+    {
+        summary.burnout_time = burnout_time;
+        summary.burnout_asl = burnout_asl[lane];
+        summary.burnout_vel = burnout_vel[lane];
+    }
+
+    summary.landed = true;
+    summary.impact_time = s.t;
+    summary.impact_vel = s.vel[lane];
+    summary.impact_downrange = s.downrange[lane];
+
+    return summary;
+}
+
+void EnsembleSummary::Compact(const std::vector<int> &lanes)
+{
+    CompactLanes(apogee, lanes);
+    CompactLanes(apogee_t, lanes);
+    CompactLanes(max_vel, lanes);
+    CompactLanes(max_vel_t, lanes);
+    CompactLanes(max_mach, lanes);
+    CompactLanes(max_mach_t, lanes);
+    CompactLanes(max_acc, lanes);
+    CompactLanes(max_acc_t, lanes);
+    CompactLanes(max_q, lanes);
+    CompactLanes(max_q_t, lanes);
+
+    if (burnt_out)
+    {
+        CompactLanes(burnout_asl, lanes);
+        CompactLanes(burnout_vel, lanes);
+    }
+
+    if (has_prev)
+    {
+        CompactLanes(prev_asl, lanes);
+        CompactLanes(prev_vel, lanes);
+    }
+}
+
+EnsembleSummary::~EnsembleSummary()
+{
+}
@@ -0,0 +1,276 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef ENSEMBLE_H_
+#define ENSEMBLE_H_
+
+#include <vector>
+#include <algorithm>
+#include "types.h"
+#include "vehicle.h"
+#include "integrators.h"
+#include "flightsummary.h"
+
+// One lane per vehicle, laid out so Eigen can vectorise across the ensemble
+typedef Eigen::ArrayXf EnsembleArray;
+typedef Eigen::Array<bool, Eigen::Dynamic, 1> EnsembleMask;
+
+/*
+* Atmosphere over an ensemble of altitudes. Lanes in the homosphere are
+* evaluated together from the constants of the layer each one is in, the
+* rare lanes above it fall back to the scalar model.
+*/
+EnvironmentVarsT<EnsembleArray> CalculateEnsembleEnvironment(const EnsembleArray &alt);
+EnsembleArray CalculateEnsembleWind(const EnsembleArray &alt_agl, const EnsembleArray &wind_speed, float exponent);
+
+// Keep the listed lanes, in ascending order, and drop the rest
+void CompactLanes(EnsembleArray &a, const std::vector<int> &lanes);
+
+/*
+* SingleSolidMotor for many vehicles at once, in structure-of-arrays form.
+* The vehicles share the motor and the clock, so thrust is looked up once
+* per evaluation and scaled per vehicle. Works with the integration
+* policies in integrators.h unchanged.
+*/
+class SingleSolidMotorEnsemble
+{
+private:
+    SingleSolidMotor motor;
+
+    float isp;
+    float burn_time;
+    float cs_area;
+    float elevation;
+    float wind_exponent;
+
+public:
+    typedef EnsembleArray Scalar;
+    typedef PointMassStateT<EnsembleArray> State;
+    typedef PointMassDerivativeT<EnsembleArray> Derivative;
+
+    // Inputs, one lane per vehicle
+    EnsembleArray cd;
+    EnsembleArray dry_mass;
+    EnsembleArray thrust_scale;
+    EnsembleArray wind_speed;
+
+    SingleSolidMotorEnsemble(Params p, ThrustCurve curve, int n);
+
+    int Size() const;
+
+    State InitialState() const;
+    float NextEvent(float t) const;
+    EnsembleMask Landed(const State &s) const;
+    float Elevation() const;
+    float BurnTime() const;
+
+    Derivative Evaluate(const State &s) const;
+
+    // Vehicles first to first + count as an ensemble of their own
+    SingleSolidMotorEnsemble Block(int first, int count) const;
+    void Compact(const std::vector<int> &lanes);
+};
+
+/*
+* Flight statistics of every lane, updated together each step. Mirrors
+* FlightSummary, including the apogee refinement at the velocity sign
+* change, and hands each vehicle's summary over as it lands.
+*/
+class EnsembleSummary
+{
+private:
+    EnsembleArray apogee, apogee_t;
+    EnsembleArray max_vel, max_vel_t;
+    EnsembleArray max_mach, max_mach_t;
+    EnsembleArray max_acc, max_acc_t;
+    EnsembleArray max_q, max_q_t;
+
+    bool burnt_out;
+    float burnout_time;
+    EnsembleArray burnout_asl;
+    EnsembleArray burnout_vel;
+
+    float prev_t;
+    EnsembleArray prev_asl;
+    EnsembleArray prev_vel;
+    bool has_prev;
+
+public:
+    EnsembleSummary();
+
+    void Begin(int n);
+
+    // Every step, lanes outside the mask are left untouched
+    void Update(const PointMassStateT<EnsembleArray> &s, const PointMassDerivativeT<EnsembleArray> &d, const EnsembleMask &active);
+    void OnBurnout(const PointMassStateT<EnsembleArray> &s);
+    FlightSummary OnLanding(const PointMassStateT<EnsembleArray> &s, int lane) const;
+
+    void Compact(const std::vector<int> &lanes);
+
+    ~EnsembleSummary();
+};
+
+/*
+* Steps an ensemble of vehicles in lockstep, e.g.
+* EnsembleSimulator<SingleSolidMotorEnsemble, RK4>. Every lane takes the same
+* step, shortened onto burnout as in Simulator. Landed vehicles are masked
+* out of the statistics and compacted away once enough of them have
+* accumulated, so the kernels only run over vehicles still in flight. The
+* ensemble is stepped in blocks of lanes so each block's working set stays
+* in cache.
+*/
+template <typename Vehicle, typename Integrator>
+class EnsembleSimulator
+{
+private:
+    Vehicle vehicle;
+    float dt;
+    int block_size;
+
+    std::vector<FlightSummary> summaries;
+
+    static void Compact(typename Vehicle::State &s, const std::vector<int> &lanes)
+    {
+        CompactLanes(s.altitude, lanes);
+        CompactLanes(s.vel, lanes);
+        CompactLanes(s.downrange, lanes);
+        CompactLanes(s.vel_x, lanes);
+        CompactLanes(s.prop_mass, lanes);
+    }
+
+    // Run the vehicles first onwards to landing, compacting live as they land
+    void RunBlock(Vehicle live, int first)
+    {
+        int n = live.Size();
+
+        // Vehicle index of each lane, lanes are only ever removed
+        std::vector<int> index(n);
+        for (int i = 0; i < n; i++)
+        {
+            index[i] = first + i;
+        }
+
+        EnsembleMask active = EnsembleMask::Constant(n, true);
+        int num_active = n;
+
+        EnsembleSummary summary;
+        summary.Begin(n);
+
+        typename Vehicle::State state = live.InitialState();
+        typename Vehicle::Derivative d = live.Evaluate(state);
+        summary.Update(state, d, active);
+
+        bool burnt_out = false;
+
+        while (num_active > 0)
+        {
+            float h = fminf(dt, live.NextEvent(state.t) - state.t);
+
+            // Landed lanes carry on below ground until they are compacted
+            // away, masked out of the statistics and landing checks
+            Integrator::Step(live, state, d, h);
+            d = live.Evaluate(state);
+
+            if (!burnt_out && state.t >= live.BurnTime())
+            {
+                summary.OnBurnout(state);
+                burnt_out = true;
+            }
+
+            summary.Update(state, d, active);
+
+            EnsembleMask landed = active && live.Landed(state);
+
+            if (!landed.any())
+            {
+                continue;
+            }
+
+            for (int lane = 0; lane < (int)index.size(); lane++)
+            {
+                if (landed[lane])
+                {
+                    summaries[index[lane]] = summary.OnLanding(state, lane);
+                }
+            }
+
+            active = active && !landed;
+            num_active = active.count();
+
+            // Dropping lanes costs a pass over the state, so wait until a
+            // quarter of them are idle
+            if (num_active > 0 && 4 * num_active <= 3 * (int)index.size())
+            {
+                std::vector<int> lanes;
+                lanes.reserve(num_active);
+
+                for (int lane = 0; lane < (int)index.size(); lane++)
+                {
+                    if (active[lane])
+                    {
+                        lanes.push_back(lane);
+                        index[lanes.size() - 1] = index[lane];
+                    }
+                }
+
+                index.resize(lanes.size());
+                Compact(state, lanes);
+                live.Compact(lanes);
+                summary.Compact(lanes);
+
+                active = EnsembleMask::Constant(num_active, true);
+                d = live.Evaluate(state);
+            }
+        }
+    }
+
+public:
+    // Lanes stepped together, small enough for the block's state to stay in cache
+    static const int default_block_size = 512;
+
+    EnsembleSimulator(Vehicle _vehicle, float _dt, int _block_size = default_block_size)
+        : vehicle(_vehicle), dt(_dt), block_size(_block_size)
+    {
+    }
+
+    void RunSimulation()
+    {
+        int n = vehicle.Size();
+
+        summaries.assign(n, FlightSummary());
+
+        for (int first = 0; first < n; first += block_size)
+        {
+            RunBlock(vehicle.Block(first, std::min(block_size, n - first)), first);
+        }
+    }
+
+    // Summary of each vehicle, by its lane in the initial ensemble
+    const std::vector<FlightSummary> &Summaries() const
+    {
+        return summaries;
+    }
+};
+
+#endif
@@ -0,0 +1,329 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "envelope.h"
+#include "system.h"
+#include "workstealing.h"
+#include <memory>
+#include <algorithm>
+#include <math.h>
+
+StreamingHistogram::StreamingHistogram()
+{
+    lower = 0.0f;
+    upper = 0.0f;
+    total = 0;
+    min = INFINITY;
+    max = -INFINITY;
+}
+
+StreamingHistogram::StreamingHistogram(float _lower, float _upper, int bins)
+{
+    lower = _lower;
+    upper = _upper;
+    counts.assign(std::max(bins, 1) + 2, 0);
+    total = 0;
+    min = INFINITY;
+    max = -INFINITY;
+}
+
+void StreamingHistogram::Add(float x)
+{
+    int bins = counts.size() - 2;
+    size_t index;
+
+    if (x < lower)
+    {
+        index = 0;
+    }
+    else if (x >= upper)
+    {
+        index = bins + 1;
+    }
+    else
+    {
+        index = 1 + std::min((int)((x - lower) / (upper - lower) * bins), bins - 1);
+    }
+
+    counts[index]++;
+    total++;
+    min = fmin(min, x);
+    max = fmax(max, x);
+}
+
+void StreamingHistogram::Merge(const StreamingHistogram &other)
+{
+    if (counts.empty())
+    {
+        *this = other;
+        return;
+    }
+
+    for (size_t i = 0; i < counts.size() && i < other.counts.size(); i++)
+    {
+        counts[i] += other.counts[i];
+    }
+
+    total += other.total;
+    min = fmin(min, other.min);
+    max = fmax(max, other.max);
+}
+
+uint64_t StreamingHistogram::Count() const
+{
+    return total;
+}
+
+float StreamingHistogram::Quantile(float q) const
+{
+    if (total == 0)
+    {
+        return NAN;
+    }
+
+    int bins = counts.size() - 2;
+    float width = (upper - lower) / bins;
+    double rank = Clamp(q, 1.0f, 0.0f) * total;
+    double below = 0.0;
+
+    for (size_t i = 0; i < counts.size(); i++)
+    {
+        if (counts[i] == 0 || below + counts[i] < rank)
+        {
+            below += counts[i];
+            continue;
+        }
+
+        // Outside the range only the extremes are known
+        if (i == 0)
+        {
+            return min;
+        }
+
+        if ((int)i == bins + 1)
+        {
+            return max;
+        }
+
+        float bin_lower = lower + (i - 1) * width;
+        float value = bin_lower + (float)((rank - below) / counts[i]) * width;
+
+        return Clamp(value, max, min);
+    }
+
+    return max;
+}
+
+StreamingHistogram::~StreamingHistogram()
+{
+}
+
+EnvelopeAggregator::EnvelopeAggregator()
+{
+    buckets = 0;
+}
+
+EnvelopeAggregator::EnvelopeAggregator(const EnvelopeParameters &_config)
+{
+    config = _config;
+    buckets = config.interval > 0 ? (size_t)floorf(config.duration / config.interval) + 1 : 0;
+
+    std::vector<StreamingHistogram> row;
+
+    for (size_t c = 0; c < config.channels.size(); c++)
+    {
+        int ch = FindChannel(config.channels[c].channel);
+
+        if (ch < 0)
+        {
+            continue;
+        }
+
+        channels.push_back(ch);
+        row.push_back(StreamingHistogram(config.channels[c].min, config.channels[c].max, config.bins));
+    }
+
+    histograms.reserve(buckets * row.size());
+
+    for (size_t b = 0; b < buckets; b++)
+    {
+        histograms.insert(histograms.end(), row.begin(), row.end());
+    }
+}
+
+size_t EnvelopeAggregator::NumBuckets() const
+{
+    return buckets;
+}
+
+const std::vector<int> &EnvelopeAggregator::Channels() const
+{
+    return channels;
+}
+
+float EnvelopeAggregator::BucketTime(size_t bucket) const
+{
+    return bucket * config.interval;
+}
+
+void EnvelopeAggregator::Add(const TrajectoryRecorder &trajectory)
+{
+    if (buckets == 0)
+    {
+        return;
+    }
+
+    ColumnView time = trajectory.Column(CH_T);
+
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        if (!trajectory.Channels().Contains(channels[c]))
+        {
+            continue;
+        }
+
+        ColumnView values = trajectory.Column(channels[c]);
+
+        for (size_t i = 0; i < time.Size(); i++)
+        {
+            // Event and landing samples fall between the bucket times
+            float position = time[i] / config.interval;
+            size_t bucket = (size_t)lroundf(position);
+
+            if (fabs(position - bucket) > 1e-3f || bucket >= buckets)
+            {
+                continue;
+            }
+
+            histograms[bucket * channels.size() + c].Add(values[i]);
+        }
+    }
+}
+
+void EnvelopeAggregator::Merge(const EnvelopeAggregator &other)
+{
+    if (histograms.empty())
+    {
+        *this = other;
+        return;
+    }
+
+    for (size_t i = 0; i < histograms.size() && i < other.histograms.size(); i++)
+    {
+        histograms[i].Merge(other.histograms[i]);
+    }
+}
+
+const StreamingHistogram &EnvelopeAggregator::Histogram(size_t bucket, size_t channel) const
+{
+    return histograms[bucket * channels.size() + channel];
+}
+
+size_t EnvelopeAggregator::MemoryUsage() const
+{
+    size_t bytes = sizeof(*this) + histograms.size() * sizeof(StreamingHistogram);
+
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        bytes += buckets * (config.bins + 2) * sizeof(uint32_t);
+    }
+
+    return bytes;
+}
+
+EnvelopeAggregator::~EnvelopeAggregator()
+{
+}
+
+EnvelopeAggregator SimulateEnvelope(const Params &base, int threads, const MonteCarloRun *runs, int n)
+{
+    WorkStealingScheduler scheduler(std::max(threads, 0));
+    std::vector<EnvelopeAggregator> partial(scheduler.NumThreads(), EnvelopeAggregator(base.envelope));
+
+    // Recorded at the bucket times only, without the recording filters
+    Params p = base;
+    p.sim.outputStep = base.envelope.interval;
+    p.sim.recordOutput = true;
+    p.sim.channels.assign(1, "Time");
+    p.recording = RecordingParameters();
+
+    for (size_t c = 0; c < base.envelope.channels.size(); c++)
+    {
+        p.sim.channels.push_back(base.envelope.channels[c].channel);
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        std::shared_ptr<System> s;
+        const MonteCarloRun *run = &runs[i];
+        std::vector<EnvelopeAggregator> *aggregators = &partial;
+
+        scheduler.Submit([&p, run, aggregators, s]() mutable
+        {
+            if (!s)
+            {
+                Params dispersed = Disperse(p, run->z);
+
+                // Disperse turns recording off for summary-only campaigns
+                dispersed.sim.recordOutput = true;
+
+                s = std::make_shared<System>(dispersed);
+                s->Begin();
+            }
+
+            for (int k = 0; k < MonteCarloRunner::checkpoint_steps; k++)
+            {
+                if (!s->Step())
+                {
+                    (*aggregators)[WorkStealingScheduler::CurrentWorker()].Add(s->output);
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    scheduler.Run();
+
+    // Pairwise tree reduction, each level's merges run side by side
+    for (size_t stride = 1; stride < partial.size(); stride *= 2)
+    {
+        for (size_t i = 0; i + stride < partial.size(); i += 2 * stride)
+        {
+            EnvelopeAggregator *target = &partial[i];
+            const EnvelopeAggregator *source = &partial[i + stride];
+
+            scheduler.Submit([target, source]()
+            {
+                target->Merge(*source);
+                return false;
+            });
+        }
+
+        scheduler.Run();
+    }
+
+    return partial.empty() ? EnvelopeAggregator(base.envelope) : partial[0];
+}
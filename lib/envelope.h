@@ -0,0 +1,109 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef ENVELOPE_H_
+#define ENVELOPE_H_
+
+#include <vector>
+#include <stdint.h>
+#include "types.h"
+#include "recorder.h"
+#include "montecarlo.h"
+
+/*
+* Histogram of fixed width bins across a range, with a bin either side for
+* values outside it and the exact extremes. Histograms over the same range
+* merge by adding counts, so partial results combine in any order.
+*/
+class StreamingHistogram
+{
+private:
+    float lower;
+    float upper;
+    // Underflow, the bins across the range, then overflow
+    std::vector<uint32_t> counts;
+    uint64_t total;
+    float min;
+    float max;
+
+public:
+    StreamingHistogram();
+
+    StreamingHistogram(float _lower, float _upper, int bins);
+
+    void Add(float x);
+    void Merge(const StreamingHistogram &other);
+
+    uint64_t Count() const;
+    // Interpolated within the bin, so accurate to a bin width inside the range
+    float Quantile(float q) const;
+
+    ~StreamingHistogram();
+};
+
+/*
+* Percentile envelopes of a campaign. Each run is sampled at the start of
+* every time bucket and each sample goes into the histogram of its channel
+* and bucket, so the memory taken is fixed by the buckets, channels and bins
+* however many runs there are. Runs that have landed add nothing to later
+* buckets.
+*/
+class EnvelopeAggregator
+{
+private:
+    EnvelopeParameters config;
+    std::vector<int> channels;
+    size_t buckets;
+
+    // Bucket major, one histogram per channel
+    std::vector<StreamingHistogram> histograms;
+
+public:
+    EnvelopeAggregator();
+
+    EnvelopeAggregator(const EnvelopeParameters &_config);
+
+    size_t NumBuckets() const;
+    const std::vector<int> &Channels() const;
+    float BucketTime(size_t bucket) const;
+
+    // Samples of one run at the bucket times, others are skipped
+    void Add(const TrajectoryRecorder &trajectory);
+    void Merge(const EnvelopeAggregator &other);
+
+    const StreamingHistogram &Histogram(size_t bucket, size_t channel) const;
+    size_t MemoryUsage() const;
+
+    ~EnvelopeAggregator();
+};
+
+/*
+* Simulate runs from their deviates on a work-stealing scheduler and return
+* their envelope. Each worker adds its finished runs to its own aggregator,
+* and the aggregators are merged pairwise in parallel at the end, so runs
+* only hold their trajectory until they are added.
+*/
+EnvelopeAggregator SimulateEnvelope(const Params &base, int threads, const MonteCarloRun *runs, int n);
+
+#endif
@@ -24,10 +24,16 @@
 
 #include<math.h>
 #include "types.h"
+#include "dual.h"
 
-inline float HeterosphereEquation(float alt, float a, float b, float c, float d, float e)
+/*
+* The atmosphere functions are generic over the scalar type so the same model
+* runs with float and with Dual numbers for sensitivity analysis
+*/
+template <typename T>
+inline T HeterosphereEquation(T alt, float a, float b, float c, float d, float e)
 {
-    float alt_km = alt / 1000.0f;
+    T alt_km = alt / 1000.0f;
 
     return exp(a * pow(alt_km, 4) 
                + b * pow(alt_km, 3) 
@@ -36,73 +42,78 @@ inline float HeterosphereEquation(float alt, float a, float b, float c, float d,
                + e);
 }
 
-inline float CalculateGeopotentialAltitude(float alt)
+template <typename T>
+inline T CalculateGeopotentialAltitude(T alt)
 {
     return earth_radius * alt / (earth_radius + alt);
 }
 
-inline float CalculateGravity(float alt)
+template <typename T>
+inline T CalculateGravity(T alt)
 {
     return g_0 * pow((earth_radius / (earth_radius + alt)), 2);
 }
 
-inline TempFunction CalculateTemperature(float alt, float geo_alt)
+template <typename T>
+inline TempFunctionT<T> CalculateTemperature(T alt, T geo_alt)
 {
-    TempFunction tempFunc;
+    TempFunctionT<T> tempFunc;
     
-    if(0 <= geo_alt <= 11000)
+    // Homosphere layers are bounded by geopotential altitude
+    if(geo_alt <= 11000.0f)
     {
         tempFunc.temp = 288.15f + (lm[0] * (geo_alt - 0.0f));
         tempFunc.b = 0;
         return tempFunc;
     }
-    else if(11000.0f < geo_alt <= 20000.0f)
+    else if(geo_alt <= 20000.0f)
     {
         tempFunc.temp = 216.65f + (lm[1] * (geo_alt - 11000.0f));
         tempFunc.b = 1;
         return tempFunc;
     }
-    else if(20000.0f < geo_alt <= 32000.0f)
+    else if(geo_alt <= 32000.0f)
     {
         tempFunc.temp = 216.65f + (lm[2] * (geo_alt - 20000.0f));
         tempFunc.b = 2;
         return tempFunc;
     }
-    else if(32000.0f < geo_alt <= 47000.0f)
+    else if(geo_alt <= 47000.0f)
     {
         tempFunc.temp = 228.65f + (lm[3] * (geo_alt - 32000.0f));
         tempFunc.b = 3;
         return tempFunc;
     }
-    else if(47000.0f < geo_alt <= 51000.0f)
+    else if(geo_alt <= 51000.0f)
     {
         tempFunc.temp = 270.65f + (lm[4] * (geo_alt - 47000.0f));
         tempFunc.b = 4;
         return tempFunc;
     }
-    else if(51000.0f < geo_alt <= 71000.0f)
+    else if(geo_alt <= 71000.0f)
     {
         tempFunc.temp = 270.65f + (lm[5] * (geo_alt - 51000.0f));
         tempFunc.b = 5;
         return tempFunc;
     }
-    else if(71000.0f < geo_alt <= 84852.0f)
+    else if(geo_alt <= 84852.0f)
     {
         tempFunc.temp = 214.65f + (lm[6] * (geo_alt - 71000.0f));
         tempFunc.b = 6;
         return tempFunc;
     }
-    else if(86000.0f < geo_alt <= 91000.0f)
+    // Heterosphere layers are bounded by geometric altitude
+    else if(alt <= 91000.0f)
     {
         tempFunc.temp = 186.87f;
         tempFunc.b = 7;
         return tempFunc;
     }
-    else if (91000.0f < geo_alt <= 110000.0f)
+    else if (alt <= 110000.0f)
     {
         float layer;
 
-        if (91000.0f < geo_alt <= 100000.0f)
+        if (alt <= 100000.0f)
         {
             layer = 8;
         }
@@ -111,36 +122,36 @@ inline TempFunction CalculateTemperature(float alt, float geo_alt)
             layer = 9;
         }
 
-        tempFunc.temp = 263.1905f - 76.3232f * sqrt(1.0f - pow(((geo_alt - 91000.0f) / -19942.9f), 2));
+        tempFunc.temp = 263.1905f - 76.3232f * sqrt(1.0f - pow(((alt - 91000.0f) / -19942.9f), 2));
         tempFunc.b = layer;
         return tempFunc;
     }
-    else if(110000.0f < geo_alt <= 120000.0f)
+    else if(alt <= 120000.0f)
     {
-        tempFunc.temp = 240.0f + 0.012f * (geo_alt - 110000);
+        tempFunc.temp = 240.0f + 0.012f * (alt - 110000);
         tempFunc.b = 10;
         return tempFunc;
     }
-    else if(120000.0f < geo_alt <= 1000000.0f)
+    else
     {
         float layer;
-        if(120000.0f < geo_alt <= 150000.0f)
+        if(alt <= 150000.0f)
         {
             layer = 11;
         }
-        else if(150000.0f < geo_alt <= 200000.0f)
+        else if(alt <= 200000.0f)
         {
             layer = 12;
         }
-        else if(200000.0f < geo_alt <= 300000.0f)
+        else if(alt <= 300000.0f)
         {
             layer = 13;
         }
-        else if(300000.0f < geo_alt <= 500000.0f)
+        else if(alt <= 500000.0f)
         {
             layer = 14;
         }
-        else if(500000.0f < geo_alt <= 750000.0f)
+        else if(alt <= 750000.0f)
         {
             layer = 15;
         }
@@ -149,7 +160,7 @@ inline TempFunction CalculateTemperature(float alt, float geo_alt)
             layer = 16;
         }
 
-        float xi = (geo_alt - 120000.0f) * (6356766.0f + 120000.0f) / (6356766.0f + geo_alt);
+        T xi = (alt - 120000.0f) * (6356766.0f + 120000.0f) / (6356766.0f + alt);
 
         tempFunc.temp = 1000.0f - 640.0f * exp(-0.00001875f * xi);
         tempFunc.b = layer;
@@ -158,7 +169,8 @@ inline TempFunction CalculateTemperature(float alt, float geo_alt)
     }
 }
 
-inline float CalculatePressure(float alt, float geo_alt, float temp, int b)
+template <typename T>
+inline T CalculatePressure(T alt, T geo_alt, T temp, int b)
 {
     if(b <= 6)
     {
@@ -217,7 +229,8 @@ inline float CalculatePressure(float alt, float geo_alt, float temp, int b)
     }
 }
 
-inline float CalculateDensity(float alt, float pressure, float temp, int b)
+template <typename T>
+inline T CalculateDensity(T alt, T pressure, T temp, int b)
 {
     if(b <= 6)
     {
@@ -270,16 +283,32 @@ inline float CalculateDensity(float alt, float pressure, float temp, int b)
     }
 }
 
-inline float CalculateMach(float temp)
+template <typename T>
+inline T CalculateMach(T temp)
 {
     return sqrt((air_gamma * gas_constant * temp) / air_molar_mass);
 }
 
-inline EnvironmentVars CalculateEnvironmentVariables(float alt)
+/*
+* Power law wind profile, referenced to 10 m above ground level
+*/
+template <typename T>
+inline T CalculateWind(T alt_agl, T wind_speed, float exponent)
+{
+    if (alt_agl <= 0)
+    {
+        return 0;
+    }
+
+    return wind_speed * pow(alt_agl / 10.0f, exponent);
+}
+
+template <typename T>
+inline EnvironmentVarsT<T> CalculateEnvironmentVariables(T alt)
 {
-    EnvironmentVars vars;
+    EnvironmentVarsT<T> vars;
 
-    float geo_alt = round(CalculateGeopotentialAltitude(alt));
+    T geo_alt = round(CalculateGeopotentialAltitude(alt));
     vars.g = CalculateGravity(alt);
     vars.tempFunc = CalculateTemperature(alt, geo_alt);
     vars.pressure = CalculatePressure(alt, geo_alt, vars.tempFunc.temp, (int)vars.tempFunc.b);
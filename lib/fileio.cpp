@@ -20,7 +20,12 @@
  */
 
 #include "fileio.h"
+#include "trajectoryfile.h"
+#include "csvwriter.h"
+#include "sampling.h"
 #include <iostream>
+#include <sstream>
+#include <algorithm>
 
 FileIO::FileIO() { }
 
@@ -209,6 +214,60 @@ Params FileIO::ParseRocketConfig(const char *file_path)
                     p.aero.cs_area = std::stof((std::string)cit_val.value());
             }
         }
+        else if(node_name == (std::string)"Recording")
+        {
+            for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
+            {
+                pugi::xml_attribute cit_val = cit->attribute("value");
+                pugi::xml_attribute cit_name = cit->attribute("name");
+
+                std::string child_node_name = (std::string)cit_name.value();
+
+                if(child_node_name == (std::string)"interval")
+                    p.recording.interval = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"event_window_before")
+                    p.recording.event_window_before = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"event_window_after")
+                    p.recording.event_window_after = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"deadband")
+                {
+                    // Written as channel:threshold pairs, e.g. "ASL:10,Vel:1"
+                    std::stringstream entries((std::string)cit_val.value());
+                    std::string entry;
+
+                    while(std::getline(entries, entry, ','))
+                    {
+                        size_t split = entry.find(':');
+
+                        if(split != std::string::npos)
+                            p.recording.deadband.push_back(DeadbandParameter{entry.substr(0, split), std::stof(entry.substr(split + 1))});
+                    }
+                }
+            }
+        }
+        else if(node_name == (std::string)"Recovery")
+        {
+            for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
+            {
+                pugi::xml_attribute cit_val = cit->attribute("value");
+                pugi::xml_attribute cit_name = cit->attribute("name");
+
+                std::string child_node_name = (std::string)cit_name.value();
+
+                if(child_node_name == (std::string)"drogue_cd")
+                    p.recovery.drogue_cd = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"drogue_area")
+                    p.recovery.drogue_area = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"drogue_delay")
+                    p.recovery.drogue_delay = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"main_cd")
+                    p.recovery.main_cd = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"main_area")
+                    p.recovery.main_area = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"main_altitude")
+                    p.recovery.main_altitude = std::stof((std::string)cit_val.value());
+            }
+        }
         else if(node_name == (std::string)"Environment")
         {
             for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
@@ -236,6 +295,114 @@ Params FileIO::ParseRocketConfig(const char *file_path)
                     p.env.air_gamma = std::stof((std::string)cit_val.value());
                 else if(child_node_name == (std::string)"atmo_pressure")
                     p.env.atmo_pressure = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"wind_speed")
+                    p.env.wind_speed = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"wind_exponent")
+                    p.env.wind_exponent = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"launch_angle")
+                    p.env.launch_angle = std::stof((std::string)cit_val.value());
+            }
+        }
+        else if(node_name == (std::string)"MonteCarlo")
+        {
+            for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
+            {
+                pugi::xml_attribute cit_val = cit->attribute("value");
+                pugi::xml_attribute cit_name = cit->attribute("name");
+
+                std::string child_node_name = (std::string)cit_name.value();
+
+                if(child_node_name == (std::string)"runs")
+                    p.monte_carlo.runs = std::stoi((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"seed")
+                    p.monte_carlo.seed = (uint32_t)std::stoul((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"threads")
+                    p.monte_carlo.threads = std::stoi((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"cd_sigma")
+                    p.monte_carlo.cd_sigma = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"dry_mass_sigma")
+                    p.monte_carlo.dry_mass_sigma = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"thrust_scale_sigma")
+                    p.monte_carlo.thrust_scale_sigma = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"wind_speed_sigma")
+                    p.monte_carlo.wind_speed_sigma = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"launch_angle_sigma")
+                    p.monte_carlo.launch_angle_sigma = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"sampler")
+                    p.monte_carlo.sampler = ParseSamplerType(cit_val.value());
+                else if(child_node_name == (std::string)"tolerance")
+                    p.monte_carlo.tolerance = std::stof((std::string)cit_val.value());
+            }
+        }
+        else if(node_name == (std::string)"RangeSafety")
+        {
+            for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
+            {
+                pugi::xml_attribute cit_val = cit->attribute("value");
+                pugi::xml_attribute cit_name = cit->attribute("name");
+
+                std::string child_node_name = (std::string)cit_name.value();
+
+                if(child_node_name == (std::string)"min_downrange")
+                    p.range_safety.min_downrange = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"max_downrange")
+                    p.range_safety.max_downrange = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"stage_runs")
+                    p.range_safety.stage_runs = std::stoi((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"final_runs")
+                    p.range_safety.final_runs = std::stoi((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"max_stages")
+                    p.range_safety.max_stages = std::stoi((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"elite_fraction")
+                    p.range_safety.elite_fraction = std::stof((std::string)cit_val.value());
+            }
+        }
+        else if(node_name == (std::string)"Envelope")
+        {
+            for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
+            {
+                pugi::xml_attribute cit_val = cit->attribute("value");
+                pugi::xml_attribute cit_name = cit->attribute("name");
+
+                std::string child_node_name = (std::string)cit_name.value();
+
+                if(child_node_name == (std::string)"interval")
+                    p.envelope.interval = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"duration")
+                    p.envelope.duration = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"bins")
+                    p.envelope.bins = std::stoi((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"channels")
+                {
+                    // Written as channel:min:max triples, e.g. "ASL:0:40000,Vel:-400:1000"
+                    std::stringstream entries((std::string)cit_val.value());
+                    std::string entry;
+
+                    while(std::getline(entries, entry, ','))
+                    {
+                        size_t first = entry.find(':');
+                        size_t second = first == std::string::npos ? first : entry.find(':', first + 1);
+
+                        if(second != std::string::npos)
+                            p.envelope.channels.push_back(EnvelopeChannelParameter{entry.substr(0, first),
+                                std::stof(entry.substr(first + 1, second - first - 1)), std::stof(entry.substr(second + 1))});
+                    }
+                }
+            }
+        }
+        else if(node_name == (std::string)"Cache")
+        {
+            for (pugi::xml_node_iterator cit = it->begin(); cit != it->end(); ++cit)
+            {
+                pugi::xml_attribute cit_val = cit->attribute("value");
+                pugi::xml_attribute cit_name = cit->attribute("name");
+
+                std::string child_node_name = (std::string)cit_name.value();
+
+                if(child_node_name == (std::string)"directory")
+                    p.cache.directory = (std::string)cit_val.value();
+                else if(child_node_name == (std::string)"max_size")
+                    p.cache.max_size = std::stof((std::string)cit_val.value());
             }
         }
         else if(node_name == (std::string)"Simulation")
@@ -251,9 +418,66 @@ Params FileIO::ParseRocketConfig(const char *file_path)
                     p.sim.logFilename = (std::string)cit_val.value();
                 else if(child_node_name == (std::string)"csv_file")
                     p.sim.csvFilename = (std::string)cit_val.value();
+                else if(child_node_name == (std::string)"trajectory_file")
+                    p.sim.trajectoryFilename = (std::string)cit_val.value();
+                else if(child_node_name == (std::string)"compress_trajectory")
+                    p.sim.compressTrajectory = cit_val.as_bool();
+                else if(child_node_name == (std::string)"csv_precision")
+                {
+                    // Written as channel:digits pairs, e.g. "Time:6,ASL:3"
+                    std::stringstream entries((std::string)cit_val.value());
+                    std::string entry;
+
+                    while(std::getline(entries, entry, ','))
+                    {
+                        size_t split = entry.find(':');
+
+                        if(split != std::string::npos)
+                            p.sim.csvPrecision.push_back(CsvPrecisionParameter{entry.substr(0, split), std::stoi(entry.substr(split + 1))});
+                    }
+                }
+                else if(child_node_name == (std::string)"channels")
+                {
+                    std::stringstream names((std::string)cit_val.value());
+                    std::string name;
+
+                    while(std::getline(names, name, ','))
+                    {
+                        if(!name.empty())
+                            p.sim.channels.push_back(name);
+                    }
+                }
+                else if(child_node_name == (std::string)"output_step")
+                    p.sim.outputStep = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"coast_q")
+                    p.sim.coastDynamicPressure = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"coast_step")
+                    p.sim.coastStep = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"descent_max_drop")
+                    p.sim.descentMaxDrop = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"descent_tolerance")
+                    p.sim.descentTolerance = std::stof((std::string)cit_val.value());
+                else if(child_node_name == (std::string)"stream_output")
+                    p.sim.streamOutput = cit_val.as_bool();
+                else if(child_node_name == (std::string)"record_output")
+                    p.sim.recordOutput = cit_val.as_bool();
+                else if(child_node_name == (std::string)"print_summary")
+                    p.sim.printSummary = cit_val.as_bool();
             }
         }
     }
+
+    // Cross entropy stages need at least one run and one elite run each
+    RangeSafetyParameters &range = p.range_safety;
+    if (range.stage_runs < 1 || range.final_runs < 1 || range.max_stages < 0 || !(range.elite_fraction > 0.0f && range.elite_fraction <= 1.0f))
+    {
+        std::cout << "Error: Invalid RangeSafety parameters, clamping to valid values!" << std::endl;
+        range.stage_runs = std::max(range.stage_runs, 1);
+        range.final_runs = std::max(range.final_runs, 1);
+        range.max_stages = std::max(range.max_stages, 0);
+        range.elite_fraction = range.elite_fraction > 0.0f ? std::min(range.elite_fraction, 1.0f) : RangeSafetyParameters().elite_fraction;
+    }
+
     return p;
 }
 
@@ -288,44 +512,48 @@ ThrustCurve FileIO::ParseThrustCurve(const char *file_path)
 
 void FileIO::WriteOutput(System& s, std::string filename)
 {
-    file.open(filename);
-
-    file << "Time" << ","
-             << "ASL" << ","
-             << "Vel" << ","
-             << "Vel_Mach" << ","
-             << "Acc" << ","
-             << "Mass" << ","
-             << "Mass_flow_rate" << ","
-             << "Prop_mass" << ","
-             << "Thrust" << ","
-             << "Twr" << ","
-             << "Drag" << ","
-             << "Rho" << ","
-             << "Pressure" << ","
-             << "Temp" << ","
-             << "Gravity" << "," << std::endl;
-
-    for(int i = 0; i < s.output.vec_t.size(); i++)
+    CsvWriter csv;
+    if (!csv.Open(filename))
+    {
+        return;
+    }
+
+    const std::vector<int> &channels = s.output.ChannelList();
+
+    std::vector<std::string> names;
+    std::vector<ColumnView> columns;
+    for(size_t c = 0; c < channels.size(); c++)
+    {
+        names.push_back(GetChannelInfo(channels[c]).name);
+        columns.push_back(s.output.Column(channels[c]));
+    }
+
+    csv.WriteHeader(names);
+    csv.SetPrecision(channels, s.Parameters().sim.csvPrecision);
+
+    std::vector<float> row(columns.size());
+    for(size_t i = 0; i < s.output.Size(); i++)
     {
-        file << s.output.vec_t[i] << ","
-             << s.output.vec_asl[i] << ","
-             << s.output.vec_vel[i] << ","
-             << s.output.vec_vel_mach[i] << ","
-             << s.output.vec_acc[i] << ","
-             << s.output.vec_mass[i] << ","
-             << s.output.vec_mass_flow_rate[i] << ","
-             << s.output.vec_prop_mass[i] << ","
-             << s.output.vec_thrust[i] << ","
-             << s.output.vec_twr[i] << ","
-             << s.output.vec_drag[i] << ","
-             << s.output.vec_rho[i] << ","
-             << s.output.vec_pressure[i] << ","
-             << s.output.vec_temp[i] << ","
-             << s.output.vec_g[i] << "," << std::endl;
+        for(size_t c = 0; c < columns.size(); c++)
+        {
+            row[c] = columns[c][i];
+        }
+        csv.WriteRow(row.data());
     }
 
-    file.close();
+    csv.Close();
+}
+
+void FileIO::WriteBinaryOutput(System& s, std::string filename)
+{
+    if (s.Parameters().sim.compressTrajectory)
+    {
+        WriteCompressedTrajectoryFile(s.output, filename);
+    }
+    else
+    {
+        WriteTrajectoryFile(s.output, filename);
+    }
 }
 
 FileIO::~FileIO()
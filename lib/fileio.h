@@ -38,6 +38,7 @@ public:
     Params ParseRocketConfig(const char *file_path);
     ThrustCurve ParseThrustCurve(const char *file_path);
     void WriteOutput(System &s, std::string filename);
+    void WriteBinaryOutput(System &s, std::string filename);
 
     ~FileIO();
 };
\ No newline at end of file
@@ -0,0 +1,106 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "flightsummary.h"
+#include <math.h>
+
+FlightSummary::FlightSummary()
+{
+    Reset();
+}
+
+void FlightSummary::Reset()
+{
+    has_prev = false;
+
+    apogee = SummaryPeak{-INFINITY, 0.0f};
+    max_vel = SummaryPeak{-INFINITY, 0.0f};
+    max_mach = SummaryPeak{-INFINITY, 0.0f};
+    max_acc = SummaryPeak{-INFINITY, 0.0f};
+    max_q = SummaryPeak{-INFINITY, 0.0f};
+
+    burnt_out = false;
+    burnout_time = 0.0f;
+    burnout_asl = 0.0f;
+    burnout_vel = 0.0f;
+
+    landed = false;
+    impact_time = 0.0f;
+    impact_vel = 0.0f;
+    impact_downrange = 0.0f;
+}
+
+void FlightSummary::Peak(SummaryPeak &peak, float value, float t)
+{
+    if (value > peak.value)
+    {
+        peak.value = value;
+        peak.t = t;
+    }
+}
+
+void FlightSummary::Update(const SimSample &s)
+{
+    float t = s[CH_T];
+
+    Peak(apogee, s[CH_ASL], t);
+    Peak(max_vel, s[CH_VEL], t);
+    Peak(max_mach, s[CH_VEL_MACH], t);
+    Peak(max_acc, s[CH_ACC], t);
+    Peak(max_q, 0.5f * s[CH_RHO] * s[CH_VEL] * s[CH_VEL], t);
+
+    // Velocity is close to linear over a step, so the altitude it integrates
+    // to peaks where it crosses zero
+    if (has_prev && prev[CH_VEL] > 0 && s[CH_VEL] <= 0)
+    {
+        float h = t - prev[CH_T];
+        float tp = h * prev[CH_VEL] / (prev[CH_VEL] - s[CH_VEL]);
+
+        Peak(apogee, prev[CH_ASL] + 0.5f * prev[CH_VEL] * tp, prev[CH_T] + tp);
+    }
+
+    prev = s;
+    has_prev = true;
+}
+
+void FlightSummary::OnEvent(const FlightEvent &e, const SimSample &s)
+{
+    if (e.type == EVENT_BURNOUT)
+    {
+        burnt_out = true;
+        burnout_time = e.t;
+        burnout_asl = s[CH_ASL];
+        burnout_vel = s[CH_VEL];
+    }
+    else if (e.type == EVENT_LANDING)
+    {
+        landed = true;
+        impact_time = e.t;
+        impact_vel = s[CH_VEL];
+        impact_downrange = s[CH_DOWNRANGE];
+    }
+}
+
+FlightSummary::~FlightSummary()
+{
+}
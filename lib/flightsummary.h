@@ -0,0 +1,79 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef FLIGHTSUMMARY_H_
+#define FLIGHTSUMMARY_H_
+
+#include "types.h"
+
+// Extreme value of a channel and the time it was reached
+struct SummaryPeak
+{
+    float value;
+    float t;
+};
+
+/*
+* Flight statistics accumulated as the simulation steps, so they are
+* available without keeping the trajectory. Apogee is interpolated between
+* the steps either side of the velocity sign change, so it stays accurate
+* across the long coast and descent steps.
+*/
+class FlightSummary
+{
+private:
+    SimSample prev;
+    bool has_prev;
+
+    void Peak(SummaryPeak &peak, float value, float t);
+
+public:
+    SummaryPeak apogee;
+    SummaryPeak max_vel;
+    SummaryPeak max_mach;
+    SummaryPeak max_acc;
+    SummaryPeak max_q;
+
+    bool burnt_out;
+    float burnout_time;
+    float burnout_asl;
+    float burnout_vel;
+
+    bool landed;
+    float impact_time;
+    float impact_vel;
+    float impact_downrange;
+
+    FlightSummary();
+
+    void Reset();
+
+    // Every integration step, in time order
+    void Update(const SimSample &s);
+    // Burnout and landing, with the state at the event
+    void OnEvent(const FlightEvent &e, const SimSample &s);
+
+    ~FlightSummary();
+};
+
+#endif
@@ -0,0 +1,68 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef INTEGRATORS_H_
+#define INTEGRATORS_H_
+
+#include "vehicle.h"
+
+/*
+* Integration policies. Each advances a vehicle state by dt given the
+* derivative k1 already evaluated at the start of the step, which the
+* simulator also reuses for the logged sample.
+*/
+
+// Constant acceleration update used by System
+struct Euler
+{
+    template <typename Vehicle>
+    static void Step(const Vehicle &/*vehicle*/, typename Vehicle::State &s, const typename Vehicle::Derivative &k1, float dt)
+    {
+        s.altitude += k1.vel * dt + (k1.acc * dt * dt) / 2;
+        s.vel += k1.acc * dt;
+        s.downrange += k1.vel_x * dt + (k1.acc_x * dt * dt) / 2;
+        s.vel_x += k1.acc_x * dt;
+        s.prop_mass -= k1.mass_flow_rate * dt;
+        s.t += dt;
+    }
+};
+
+// Classical fourth order Runge-Kutta
+struct RK4
+{
+    template <typename Vehicle>
+    static void Step(const Vehicle &vehicle, typename Vehicle::State &s, const typename Vehicle::Derivative &k1, float dt)
+    {
+        typename Vehicle::Derivative k2 = vehicle.Evaluate(Advance(s, k1, dt / 2));
+        typename Vehicle::Derivative k3 = vehicle.Evaluate(Advance(s, k2, dt / 2));
+        typename Vehicle::Derivative k4 = vehicle.Evaluate(Advance(s, k3, dt));
+
+        s.altitude += dt * (k1.vel + 2.0f * k2.vel + 2.0f * k3.vel + k4.vel) / 6.0f;
+        s.vel += dt * (k1.acc + 2.0f * k2.acc + 2.0f * k3.acc + k4.acc) / 6.0f;
+        s.downrange += dt * (k1.vel_x + 2.0f * k2.vel_x + 2.0f * k3.vel_x + k4.vel_x) / 6.0f;
+        s.vel_x += dt * (k1.acc_x + 2.0f * k2.acc_x + 2.0f * k3.acc_x + k4.acc_x) / 6.0f;
+        s.prop_mass -= dt * (k1.mass_flow_rate + 2.0f * k2.mass_flow_rate + 2.0f * k3.mass_flow_rate + k4.mass_flow_rate) / 6.0f;
+        s.t += dt;
+    }
+};
+
+#endif
@@ -0,0 +1,371 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "montecarlo.h"
+#include "system.h"
+#include "workstealing.h"
+#include "resultcache.h"
+#include <memory>
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+
+const char *DispersionName(int input)
+{
+    static const char *names[DISP_COUNT] = {"Cd", "Dry_mass", "Thrust_scale", "Wind_speed", "Launch_angle"};
+
+    return names[input];
+}
+
+const char *MonteCarloOutputName(int output)
+{
+    static const char *names[MC_OUTPUT_COUNT] = {"Apogee", "Max_vel", "Max_q", "Impact_time", "Impact_downrange"};
+
+    return names[output];
+}
+
+float MonteCarloOutputValue(const FlightSummary &summary, int output)
+{
+    switch (output)
+    {
+    case MC_APOGEE:
+        return summary.apogee.value;
+    case MC_MAX_VEL:
+        return summary.max_vel.value;
+    case MC_MAX_Q:
+        return summary.max_q.value;
+    case MC_IMPACT_TIME:
+        return summary.impact_time;
+    case MC_IMPACT_DOWNRANGE:
+        return summary.impact_downrange;
+    }
+
+    return 0.0f;
+}
+
+Params Disperse(const Params &base, const float z[DISP_COUNT])
+{
+    const MonteCarloParameters &mc = base.monte_carlo;
+    Params p = base;
+
+    // Scale factors are kept positive for tail deviates
+    p.aero.cd = base.aero.cd * fmax(1.0f + mc.cd_sigma * z[DISP_CD], 0.01f);
+    p.dryMass = fmax(base.dryMass + mc.dry_mass_sigma * z[DISP_DRY_MASS], 0.01f * base.dryMass);
+    p.engine.avg_thrust = base.engine.avg_thrust * fmax(1.0f + mc.thrust_scale_sigma * z[DISP_THRUST_SCALE], 0.01f);
+    p.env.wind_speed = base.env.wind_speed + mc.wind_speed_sigma * z[DISP_WIND_SPEED];
+    p.env.launch_angle = base.env.launch_angle + mc.launch_angle_sigma * z[DISP_LAUNCH_ANGLE];
+
+    p.sim.recordOutput = false;
+    p.sim.streamOutput = false;
+    p.sim.printSummary = false;
+
+    return p;
+}
+
+void DrawDeviates(const MonteCarloParameters &config, uint32_t run, float z[DISP_COUNT])
+{
+    DispersionSampler sampler(config.sampler, config.seed, DISP_COUNT, std::max(config.runs, 0));
+
+    for (int k = 0; k < DISP_COUNT; k++)
+    {
+        sampler.Normals(k, run, 1, &z[k]);
+    }
+}
+
+double SimulateRuns(const Params &base, int threads, MonteCarloRun *runs, int n)
+{
+    WorkStealingScheduler scheduler(std::max(threads, 0));
+    ResultCache cache(base.cache);
+
+    // Keys of the runs that missed the cache, stored once they finish
+    std::vector<std::string> keys(cache.Enabled() ? n : 0);
+    std::vector<std::vector<FlightEvent>> events(keys.size());
+
+    for (int i = 0; i < n; i++)
+    {
+        // Set up on the first slice, so only runs in progress hold a System
+        std::shared_ptr<System> s;
+        MonteCarloRun *run = &runs[i];
+        std::vector<FlightEvent> *run_events = cache.Enabled() ? &events[i] : nullptr;
+
+        if (cache.Enabled())
+        {
+            CachedResult result;
+            // No curve to key on: System flies the constant avg_thrust, which the
+            // params already cover. Key on the curve once System flies one.
+            keys[i] = ResultCache::Key(Disperse(base, run->z), ThrustCurve());
+
+            if (cache.Load(keys[i], result))
+            {
+                run->summary = result.summary;
+                keys[i].clear();
+                continue;
+            }
+        }
+
+        scheduler.Submit([&base, run, run_events, s]() mutable
+        {
+            if (!s)
+            {
+                s = std::make_shared<System>(Disperse(base, run->z));
+                s->Begin();
+            }
+
+            for (int k = 0; k < MonteCarloRunner::checkpoint_steps; k++)
+            {
+                if (!s->Step())
+                {
+                    run->summary = s->summary;
+                    if (run_events)
+                    {
+                        *run_events = s->events;
+                    }
+                    return false;
+                }
+            }
+
+            return true;
+        });
+    }
+
+    scheduler.Run();
+
+    if (cache.Enabled())
+    {
+        for (int i = 0; i < n; i++)
+        {
+            if (!keys[i].empty())
+            {
+                cache.Store(keys[i], runs[i].summary, events[i], nullptr);
+            }
+        }
+    }
+
+    return scheduler.Utilisation();
+}
+
+MonteCarloRunner::MonteCarloRunner(const Params &_base)
+{
+    base = _base;
+    config = base.monte_carlo;
+    settled = false;
+    utilisation = 0.0;
+}
+
+void MonteCarloRunner::Run()
+{
+    int total = std::max(config.runs, 0);
+    DispersionSampler sampler(config.sampler, config.seed, DISP_COUNT, total);
+
+    runs.clear();
+    runs.reserve(total);
+    checkpoints.clear();
+    settled = false;
+    utilisation = 0.0;
+
+    // Sobol points are balanced at powers of two, so batches double
+    int size = sampler.Extensible() ? std::min(first_checkpoint, total) : total;
+
+    while ((int)runs.size() < total)
+    {
+        RunBatch(sampler, runs.size(), size - runs.size());
+        AddCheckpoint();
+
+        if (config.tolerance > 0 && sampler.Extensible() && checkpoints.back().change < config.tolerance)
+        {
+            settled = true;
+            break;
+        }
+
+        size = std::min(2 * size, total);
+    }
+
+    // Once per campaign, as it visits every entry
+    ResultCache(base.cache).Trim();
+}
+
+void MonteCarloRunner::RunBatch(const DispersionSampler &sampler, int first, int n)
+{
+    runs.resize(first + n);
+
+    // Deviates are drawn up front, one input at a time across the batch
+    std::vector<float> z(n);
+
+    for (int k = 0; k < DISP_COUNT; k++)
+    {
+        sampler.Normals(k, first, n, z.data());
+
+        for (int i = 0; i < n; i++)
+        {
+            runs[first + i].z[k] = z[i];
+        }
+    }
+
+    double batch_utilisation = SimulateRuns(base, config.threads, &runs[first], n);
+
+    // Averaged over the batches by their number of runs
+    utilisation += (batch_utilisation - utilisation) * n / runs.size();
+}
+
+void MonteCarloRunner::AddCheckpoint()
+{
+    MonteCarloCheckpoint checkpoint;
+
+    checkpoint.runs = runs.size();
+    checkpoint.change = INFINITY;
+
+    for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+    {
+        checkpoint.stats[k] = Statistic(k);
+    }
+
+    if (!checkpoints.empty())
+    {
+        const MonteCarloCheckpoint &prev = checkpoints.back();
+
+        checkpoint.change = 0.0f;
+
+        for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+        {
+            const MonteCarloStatistic &a = prev.stats[k];
+            const MonteCarloStatistic &b = checkpoint.stats[k];
+
+            if (b.stddev <= 0)
+            {
+                continue;
+            }
+
+            float moved = fmax(fabs(b.mean - a.mean), fabs(b.stddev - a.stddev));
+
+            checkpoint.change = fmax(checkpoint.change, moved / b.stddev);
+        }
+    }
+
+    checkpoints.push_back(checkpoint);
+}
+
+MonteCarloRun MonteCarloRunner::Replay(int index) const
+{
+    MonteCarloRun run;
+    DrawDeviates(config, index, run.z);
+
+    System s(Disperse(base, run.z));
+    s.RunSimulation();
+    run.summary = s.summary;
+
+    return run;
+}
+
+const std::vector<MonteCarloRun> &MonteCarloRunner::Runs() const
+{
+    return runs;
+}
+
+const std::vector<MonteCarloCheckpoint> &MonteCarloRunner::Checkpoints() const
+{
+    return checkpoints;
+}
+
+bool MonteCarloRunner::Settled() const
+{
+    return settled;
+}
+
+double MonteCarloRunner::Utilisation() const
+{
+    return utilisation;
+}
+
+MonteCarloStatistic MonteCarloRunner::Statistic(int output) const
+{
+    MonteCarloStatistic stat = {};
+
+    if (runs.empty())
+    {
+        return stat;
+    }
+
+    std::vector<float> values(runs.size());
+    double sum = 0.0;
+
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        values[i] = MonteCarloOutputValue(runs[i].summary, output);
+        sum += values[i];
+    }
+
+    stat.mean = sum / values.size();
+
+    double sum_sq = 0.0;
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        sum_sq += pow(values[i] - stat.mean, 2);
+    }
+    stat.stddev = values.size() > 1 ? sqrt(sum_sq / (values.size() - 1)) : 0.0f;
+
+    std::sort(values.begin(), values.end());
+    stat.min = values.front();
+    stat.max = values.back();
+    stat.p05 = values[(size_t)(0.05 * (values.size() - 1))];
+    stat.p50 = values[(size_t)(0.50 * (values.size() - 1))];
+    stat.p95 = values[(size_t)(0.95 * (values.size() - 1))];
+
+    return stat;
+}
+
+void MonteCarloRunner::PrintSummary() const
+{
+    std::cout << "Monte Carlo runs: " << runs.size() << ", " << SamplerName(config.sampler) << " sampling" << std::endl;
+
+    for (size_t i = 0; i < checkpoints.size(); i++)
+    {
+        std::cout << "Checkpoint " << checkpoints[i].runs << " runs: ";
+
+        if (isinf(checkpoints[i].change))
+        {
+            std::cout << "first" << std::endl;
+        }
+        else
+        {
+            std::cout << "change " << checkpoints[i].change << " sd" << std::endl;
+        }
+    }
+
+    if (config.tolerance > 0)
+    {
+        std::cout << (settled ? "Settled within " : "Not settled within ") << config.tolerance << " sd" << std::endl;
+    }
+
+    for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+    {
+        MonteCarloStatistic stat = Statistic(k);
+
+        std::cout << MonteCarloOutputName(k) << ": mean " << stat.mean << ", sd " << stat.stddev
+                  << ", min " << stat.min << ", 5% " << stat.p05 << ", 50% " << stat.p50
+                  << ", 95% " << stat.p95 << ", max " << stat.max << std::endl;
+    }
+}
+
+MonteCarloRunner::~MonteCarloRunner()
+{
+}
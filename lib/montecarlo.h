@@ -0,0 +1,153 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef MONTECARLO_H_
+#define MONTECARLO_H_
+
+#include <vector>
+#include "types.h"
+#include "flightsummary.h"
+#include "sampling.h"
+
+// Dispersed inputs, each drawn as a standard normal deviate
+enum DispersionInput
+{
+    DISP_CD,
+    DISP_DRY_MASS,
+    DISP_THRUST_SCALE,
+    DISP_WIND_SPEED,
+    DISP_LAUNCH_ANGLE,
+    DISP_COUNT
+};
+
+// Aggregated outputs of each run
+enum MonteCarloOutput
+{
+    MC_APOGEE,
+    MC_MAX_VEL,
+    MC_MAX_Q,
+    MC_IMPACT_TIME,
+    MC_IMPACT_DOWNRANGE,
+    MC_OUTPUT_COUNT
+};
+
+const char *DispersionName(int input);
+const char *MonteCarloOutputName(int output);
+float MonteCarloOutputValue(const FlightSummary &summary, int output);
+
+/*
+* Parameters of one run from the standard normal deviates of each input,
+* scaled by the campaign's dispersions. Runs only keep their flight summary.
+*/
+Params Disperse(const Params &base, const float z[DISP_COUNT]);
+
+// Deviates of one run, regenerated from the campaign seed and run index alone
+void DrawDeviates(const MonteCarloParameters &config, uint32_t run, float z[DISP_COUNT]);
+
+struct MonteCarloRun
+{
+    float z[DISP_COUNT];
+    FlightSummary summary;
+};
+
+/*
+* Simulate runs from their deviates on a work-stealing scheduler, filling
+* in each summary. Runs found in the result cache are not simulated again,
+* and campaigns trim the cache once at the end.
+* Returns the fraction of worker time spent simulating.
+*/
+double SimulateRuns(const Params &base, int threads, MonteCarloRun *runs, int n);
+
+struct MonteCarloStatistic
+{
+    float mean;
+    float stddev;
+    float min;
+    float max;
+    float p05;
+    float p50;
+    float p95;
+};
+
+// Campaign statistics after a batch of runs
+struct MonteCarloCheckpoint
+{
+    int runs;
+    MonteCarloStatistic stats[MC_OUTPUT_COUNT];
+
+    // Largest move of any output's mean or spread since the previous
+    // checkpoint, relative to its spread. Percentiles are order statistics
+    // and settle far slower, so they are left out.
+    float change;
+};
+
+/*
+* Runs a dispersion campaign of independent System runs on a work-stealing
+* scheduler. Runs pause every checkpoint_steps steps so long ones can move
+* between workers. Deviates come from a counter-based generator keyed by
+* the campaign seed, input and run index, so results do not depend on the
+* thread count or the order runs finish in, and any run can be replayed on
+* its own.
+*
+* Runs go in batches that double in size, with a checkpoint of the
+* statistics after each. Sobol campaigns stop once a checkpoint moves less
+* than the tolerance, Latin hypercube designs run in one batch.
+*/
+class MonteCarloRunner
+{
+private:
+    Params base;
+    MonteCarloParameters config;
+
+    std::vector<MonteCarloRun> runs;
+    std::vector<MonteCarloCheckpoint> checkpoints;
+    bool settled;
+    double utilisation;
+
+    void RunBatch(const DispersionSampler &sampler, int first, int n);
+    void AddCheckpoint();
+
+public:
+    static const int checkpoint_steps = 2000;
+    static const int first_checkpoint = 128;
+
+    MonteCarloRunner(const Params &_base);
+
+    void Run();
+    // Rerun a single run of the campaign in isolation
+    MonteCarloRun Replay(int index) const;
+
+    const std::vector<MonteCarloRun> &Runs() const;
+    // Fraction of worker time spent simulating in the last Run
+    double Utilisation() const;
+    MonteCarloStatistic Statistic(int output) const;
+    const std::vector<MonteCarloCheckpoint> &Checkpoints() const;
+    // Whether the last Run stopped on the tolerance
+    bool Settled() const;
+
+    void PrintSummary() const;
+
+    ~MonteCarloRunner();
+};
+
+#endif
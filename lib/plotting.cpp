@@ -0,0 +1,87 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "plotting.h"
+#include <iostream>
+
+#ifdef ROCKETSIM_PLOTTING
+
+#include "../include/matplotlibcpp.h"
+
+namespace plt = matplotlibcpp;
+
+bool PlottingAvailable()
+{
+    return true;
+}
+
+void PlotTrajectory(const TrajectoryRecorder &output)
+{
+    if (output.Size() == 0)
+    {
+        return;
+    }
+
+    std::vector<float> vec_t = output.Column(CH_T).ToVector();
+
+    plt::figure(1);
+    plt::xlabel("t (s)");
+    plt::ylabel("Alt (m)");
+    plt::plot(vec_t, output.Column(CH_ASL).ToVector());
+    plt::figure(2);
+    plt::xlabel("t (s)");
+    plt::ylabel("Vel (m/s)");
+    plt::plot(vec_t, output.Column(CH_VEL).ToVector(),"r");
+    plt::figure(3);
+    plt::xlabel("t (s)");
+    plt::ylabel("Vel (Mach)");
+    plt::plot(vec_t, output.Column(CH_ACC).ToVector(), "b");
+    plt::figure(4);
+    plt::xlabel("t (s)");
+    plt::ylabel("Mass (kg)");
+    plt::plot(vec_t, output.Column(CH_MASS).ToVector(),"g");
+    plt::figure(5);
+    plt::xlabel("t (s)");
+    plt::ylabel("Drag (N)");
+    plt::plot(vec_t, output.Column(CH_DRAG).ToVector(),"o");
+    plt::figure(6);
+    plt::xlabel("t (s)");
+    plt::ylabel("Atmospheric Density (kg/m^3)");
+    plt::plot(vec_t, output.Column(CH_RHO).ToVector(), "p");
+
+    plt::show();
+}
+
+#else
+
+bool PlottingAvailable()
+{
+    return false;
+}
+
+void PlotTrajectory(const TrajectoryRecorder &/*output*/)
+{
+    std::cout << "Plotting is not available, build with ROCKETSIM_PLOTTING defined" << std::endl;
+}
+
+#endif
@@ -0,0 +1,40 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef PLOTTING_H_
+#define PLOTTING_H_
+
+#include "recorder.h"
+
+/*
+* Optional plots of a recorded trajectory through matplotlib. The plotting
+* code, and with it the embedded Python interpreter, is only built when
+* ROCKETSIM_PLOTTING is defined; otherwise the core library has no Python
+* dependency and this reports that plotting is unavailable.
+*/
+bool PlottingAvailable();
+
+// Show the standard flight plots, blocking until the windows are closed
+void PlotTrajectory(const TrajectoryRecorder &output);
+
+#endif
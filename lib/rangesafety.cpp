@@ -0,0 +1,275 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "rangesafety.h"
+#include "counterrng.h"
+#include "resultcache.h"
+#include <iostream>
+#include <algorithm>
+#include <math.h>
+
+const char *RangeSafetyEdgeName(int edge)
+{
+    static const char *names[EDGE_COUNT] = {"Min_downrange", "Max_downrange"};
+
+    return names[edge];
+}
+
+float RangeSafetyEdgeMargin(const RangeSafetyParameters &range, const FlightSummary &summary, int edge)
+{
+    if (edge == EDGE_MIN_DOWNRANGE)
+    {
+        return range.min_downrange - summary.impact_downrange;
+    }
+
+    return summary.impact_downrange - range.max_downrange;
+}
+
+float RangeSafetyMargin(const RangeSafetyParameters &range, const FlightSummary &summary)
+{
+    return fmax(RangeSafetyEdgeMargin(range, summary, EDGE_MIN_DOWNRANGE), RangeSafetyEdgeMargin(range, summary, EDGE_MAX_DOWNRANGE));
+}
+
+// Likelihood ratio of the nominal standard normal to the shifted one
+static double LikelihoodRatio(const float z[DISP_COUNT], const float shift[DISP_COUNT])
+{
+    double exponent = 0.0;
+
+    for (int k = 0; k < DISP_COUNT; k++)
+    {
+        exponent += 0.5 * shift[k] * shift[k] - shift[k] * z[k];
+    }
+
+    return exp(exponent);
+}
+
+RangeSafetyAnalysis::RangeSafetyAnalysis(const Params &_base)
+{
+    base = _base;
+    config = base.monte_carlo;
+    range = base.range_safety;
+    utilisation = 0.0;
+}
+
+void RangeSafetyAnalysis::Sample(const float shift[DISP_COUNT], uint32_t draw, std::vector<MonteCarloRun> &runs)
+{
+    CounterRng rng(config.seed);
+    std::vector<float> z(runs.size());
+
+    // Each stage draws from its own counter, clear of the campaign at draw 0
+    for (int k = 0; k < DISP_COUNT; k++)
+    {
+        rng.Normals(k, 0, z.size(), z.data(), draw);
+
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            runs[i].z[k] = shift[k] + z[i];
+        }
+    }
+
+    utilisation = SimulateRuns(base, config.threads, runs.data(), runs.size());
+}
+
+RangeSafetyResult RangeSafetyAnalysis::Run()
+{
+    RangeSafetyResult result;
+    double variance = 0.0;
+
+    result.probability = 0.0;
+
+    for (int edge = 0; edge < EDGE_COUNT; edge++)
+    {
+        result.edges[edge] = RunEdge(edge);
+        result.probability += result.edges[edge].probability;
+        variance += result.edges[edge].std_error * result.edges[edge].std_error;
+    }
+
+    result.std_error = sqrt(variance);
+
+    ResultCache(base.cache).Trim();
+
+    return result;
+}
+
+RangeSafetyEdgeResult RangeSafetyAnalysis::RunEdge(int edge)
+{
+    RangeSafetyEdgeResult result = {};
+    float shift[DISP_COUNT] = {};
+
+    // An open edge cannot be crossed
+    float limit = edge == EDGE_MIN_DOWNRANGE ? range.min_downrange : range.max_downrange;
+
+    if (isinf(limit))
+    {
+        std::copy(shift, shift + DISP_COUNT, result.shift);
+        result.reached = true;
+        return result;
+    }
+
+    int elite = std::max(1, std::min((int)(range.elite_fraction * range.stage_runs), range.stage_runs));
+
+    // Each edge draws from its own counters
+    uint32_t first_draw = 1 + edge * (range.max_stages + 1);
+
+    for (int stage = 0; stage < range.max_stages && !result.reached; stage++)
+    {
+        std::vector<MonteCarloRun> runs(range.stage_runs);
+        Sample(shift, first_draw + stage, runs);
+
+        std::vector<float> margins(runs.size());
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            margins[i] = RangeSafetyEdgeMargin(range, runs[i].summary, edge);
+        }
+
+        // Level reached by the elite runs, capped at the edge
+        std::vector<float> sorted = margins;
+        std::nth_element(sorted.begin(), sorted.end() - elite, sorted.end());
+        float level = fmin(sorted[sorted.size() - elite], 0.0f);
+
+        result.reached = level >= 0;
+
+        // Weighted mean of the elite deviates is the next stage's shift
+        double weight_sum = 0.0;
+        double mean[DISP_COUNT] = {};
+
+        for (size_t i = 0; i < runs.size(); i++)
+        {
+            if (margins[i] < level)
+            {
+                continue;
+            }
+
+            double w = LikelihoodRatio(runs[i].z, shift);
+            weight_sum += w;
+
+            for (int k = 0; k < DISP_COUNT; k++)
+            {
+                mean[k] += w * runs[i].z[k];
+            }
+        }
+
+        RangeSafetyStage s;
+        s.runs = runs.size();
+        s.level = level;
+
+        for (int k = 0; k < DISP_COUNT; k++)
+        {
+            shift[k] = mean[k] / weight_sum;
+            s.shift[k] = shift[k];
+        }
+
+        result.stages.push_back(s);
+    }
+
+    std::copy(shift, shift + DISP_COUNT, result.shift);
+
+    // Final estimate, reweighted to the nominal distribution
+    std::vector<MonteCarloRun> runs(range.final_runs);
+    Sample(shift, first_draw + range.max_stages, runs);
+
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double weight_sum = 0.0;
+    double weight_sum_sq = 0.0;
+
+    result.runs = runs.size();
+    result.violations = 0;
+
+    for (size_t i = 0; i < runs.size(); i++)
+    {
+        double w = LikelihoodRatio(runs[i].z, shift);
+
+        weight_sum += w;
+        weight_sum_sq += w * w;
+
+        if (RangeSafetyEdgeMargin(range, runs[i].summary, edge) > 0)
+        {
+            result.violations++;
+            sum += w;
+            sum_sq += w * w;
+        }
+    }
+
+    int n = runs.size();
+
+    result.probability = n > 0 ? sum / n : 0.0;
+    result.std_error = n > 1 ? sqrt(fmax(sum_sq / n - result.probability * result.probability, 0.0) / (n - 1)) : 0.0;
+    result.effective_runs = weight_sum_sq > 0 ? weight_sum * weight_sum / weight_sum_sq : 0.0;
+
+    return result;
+}
+
+double RangeSafetyAnalysis::Utilisation() const
+{
+    return utilisation;
+}
+
+void RangeSafetyAnalysis::PrintResult(const RangeSafetyResult &result)
+{
+    for (int edge = 0; edge < EDGE_COUNT; edge++)
+    {
+        const RangeSafetyEdgeResult &r = result.edges[edge];
+
+        std::cout << RangeSafetyEdgeName(edge) << ":" << std::endl;
+
+        if (r.runs == 0)
+        {
+            std::cout << "    Open edge" << std::endl;
+            continue;
+        }
+
+        for (size_t i = 0; i < r.stages.size(); i++)
+        {
+            const RangeSafetyStage &s = r.stages[i];
+
+            std::cout << "    Stage " << i + 1 << ": " << s.runs << " runs, level " << s.level << " m, shift";
+            for (int k = 0; k < DISP_COUNT; k++)
+            {
+                std::cout << " " << DispersionName(k) << " " << s.shift[k];
+            }
+            std::cout << std::endl;
+        }
+
+        if (!r.reached)
+        {
+            std::cout << "    Stages did not reach the edge, the estimate may be poor" << std::endl;
+        }
+
+        std::cout << "    Violations: " << r.violations << " of " << r.runs << " runs" << std::endl;
+        std::cout << "    Probability: " << r.probability << " +/- " << r.std_error << " (1 sd)" << std::endl;
+        std::cout << "    Effective runs: " << r.effective_runs << std::endl;
+    }
+
+    std::cout << "Probability: " << result.probability << " +/- " << result.std_error << " (1 sd)";
+    if (result.probability > 0)
+    {
+        std::cout << ", relative error " << result.std_error / result.probability;
+    }
+    std::cout << std::endl;
+}
+
+RangeSafetyAnalysis::~RangeSafetyAnalysis()
+{
+}
@@ -0,0 +1,117 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef RANGESAFETY_H_
+#define RANGESAFETY_H_
+
+#include <vector>
+#include "types.h"
+#include "montecarlo.h"
+
+// Sides of the impact corridor
+enum RangeSafetyEdge
+{
+    EDGE_MIN_DOWNRANGE,
+    EDGE_MAX_DOWNRANGE,
+    EDGE_COUNT
+};
+
+const char *RangeSafetyEdgeName(int edge);
+
+// Distance of an impact beyond one edge of the corridor, negative inside it
+float RangeSafetyEdgeMargin(const RangeSafetyParameters &range, const FlightSummary &summary, int edge);
+// Distance of an impact outside the corridor, negative inside it
+float RangeSafetyMargin(const RangeSafetyParameters &range, const FlightSummary &summary);
+
+// One cross-entropy stage, the level its elite runs reached and the mean shift fitted to them
+struct RangeSafetyStage
+{
+    int runs;
+    float level;
+    float shift[DISP_COUNT];
+};
+
+// Estimate of landing beyond one edge
+struct RangeSafetyEdgeResult
+{
+    std::vector<RangeSafetyStage> stages;
+
+    // Sampling density of the final estimate, about the standard normal
+    float shift[DISP_COUNT];
+    bool reached;
+
+    int runs;
+    int violations;
+    double probability;
+    double std_error;
+    // Runs an unweighted estimate would need for the same variance of the weights
+    double effective_runs;
+};
+
+struct RangeSafetyResult
+{
+    RangeSafetyEdgeResult edges[EDGE_COUNT];
+
+    // Landing beyond either edge, the edges being disjoint and sampled apart
+    double probability;
+    double std_error;
+};
+
+/*
+* Probability of landing outside the impact corridor by importance
+* sampling. Each edge of the corridor is estimated on its own, since a
+* single sampling density can only lean towards one of them. The deviates
+* are drawn from a unit normal shifted towards the edge, with the shift
+* fitted by the cross-entropy method: each stage moves the mean onto the
+* weighted average of its most extreme runs until those runs reach the
+* edge. The final stage reweights every run by its likelihood ratio against
+* the nominal distribution, which gives an unbiased estimate and its
+* standard error from a few thousand runs where plain sampling of a 1e-5
+* event would need millions. The edge estimates are added together.
+*/
+class RangeSafetyAnalysis
+{
+private:
+    Params base;
+    MonteCarloParameters config;
+    RangeSafetyParameters range;
+
+    double utilisation;
+
+    void Sample(const float shift[DISP_COUNT], uint32_t draw, std::vector<MonteCarloRun> &runs);
+    RangeSafetyEdgeResult RunEdge(int edge);
+
+public:
+    RangeSafetyAnalysis(const Params &_base);
+
+    RangeSafetyResult Run();
+
+    double Utilisation() const;
+
+    static void PrintResult(const RangeSafetyResult &result);
+
+    ~RangeSafetyAnalysis();
+};
+
+#endif
@@ -0,0 +1,372 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#include "recorder.h"
+#include "streamwriter.h"
+#include <math.h>
+#include <iostream>
+#include <mutex>
+
+static std::mutex registry_mutex;
+
+static std::vector<ChannelInfo> BuiltInChannels()
+{
+    std::vector<ChannelInfo> registry = {
+        {"Time", "s"},
+        {"ASL", "m"},
+        {"Vel", "m/s"},
+        {"Vel_Mach", "-"},
+        {"Acc", "m/s2"},
+        {"Mass", "kg"},
+        {"Mass_flow_rate", "kg/s"},
+        {"Prop_mass", "kg"},
+        {"Thrust", "N"},
+        {"Twr", "-"},
+        {"Drag", "N"},
+        {"Rho", "kg/m3"},
+        {"Pressure", "pa"},
+        {"Temp", "K"},
+        {"Gravity", "m/s2"},
+        {"Downrange", "m"}};
+
+    // Full size up front, so registering never moves the entries
+    registry.reserve(max_channels);
+
+    return registry;
+}
+
+static std::vector<ChannelInfo> &Registry()
+{
+    static std::vector<ChannelInfo> registry = BuiltInChannels();
+
+    return registry;
+}
+
+int RegisterChannel(std::string name, std::string unit)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::vector<ChannelInfo> &registry = Registry();
+
+    for (size_t i = 0; i < registry.size(); i++)
+    {
+        if (registry[i].name == name)
+        {
+            return (int)i;
+        }
+    }
+
+    if (registry.size() >= max_channels)
+    {
+        std::cout << "Error: Too many output channels, cannot register " << name << std::endl;
+        return -1;
+    }
+
+    registry.push_back(ChannelInfo{name, unit});
+
+    return (int)registry.size() - 1;
+}
+
+int FindChannel(std::string name)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::vector<ChannelInfo> &registry = Registry();
+
+    for (size_t i = 0; i < registry.size(); i++)
+    {
+        if (registry[i].name == name)
+        {
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+int NumChannels()
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    return (int)Registry().size();
+}
+
+ChannelInfo GetChannelInfo(int ch)
+{
+    std::lock_guard<std::mutex> lock(registry_mutex);
+
+    return Registry()[ch];
+}
+
+ChannelSet::ChannelSet()
+{
+    mask = 0;
+}
+
+ChannelSet ChannelSet::All()
+{
+    ChannelSet set;
+
+    for (int ch = 0; ch < NumChannels(); ch++)
+    {
+        set.Add(ch);
+    }
+
+    return set;
+}
+
+ChannelSet ChannelSet::FromNames(const std::vector<std::string> &names)
+{
+    if (names.empty())
+    {
+        return All();
+    }
+
+    ChannelSet set;
+
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        int ch = FindChannel(names[i]);
+
+        if (ch < 0)
+        {
+            std::cout << "Error: Unknown output channel " << names[i] << std::endl;
+            continue;
+        }
+
+        set.Add(ch);
+    }
+
+    // Time is always recorded
+    set.Add(CH_T);
+
+    return set;
+}
+
+// Ids outside the mask, such as the -1 of a failed registration, are ignored
+void ChannelSet::Add(int ch)
+{
+    if (ch >= 0 && ch < max_channels)
+    {
+        mask |= (uint32_t)1 << ch;
+    }
+}
+
+bool ChannelSet::Contains(int ch) const
+{
+    return ch >= 0 && ch < max_channels && ((mask >> ch) & 1);
+}
+
+std::vector<int> ChannelSet::List() const
+{
+    std::vector<int> list;
+
+    for (int ch = 0; ch < max_channels; ch++)
+    {
+        if (Contains(ch))
+        {
+            list.push_back(ch);
+        }
+    }
+
+    return list;
+}
+
+ColumnView::ColumnView(const std::vector<std::vector<float>> *_chunks, size_t _offset, size_t _size)
+{
+    chunks = _chunks;
+    offset = _offset;
+    size = _size;
+}
+
+size_t ColumnView::Size() const
+{
+    return size;
+}
+
+float ColumnView::operator[](size_t i) const
+{
+    const size_t n = TrajectoryRecorder::chunk_size;
+
+    return (*chunks)[i / n][offset + i % n];
+}
+
+size_t ColumnView::NumChunks() const
+{
+    const size_t n = TrajectoryRecorder::chunk_size;
+
+    return (size + n - 1) / n;
+}
+
+const float *ColumnView::ChunkData(size_t k) const
+{
+    return (*chunks)[k].data() + offset;
+}
+
+size_t ColumnView::ChunkLength(size_t k) const
+{
+    const size_t n = TrajectoryRecorder::chunk_size;
+
+    return k + 1 < NumChunks() ? n : size - k * n;
+}
+
+std::vector<float> ColumnView::ToVector() const
+{
+    std::vector<float> vec;
+    vec.reserve(size);
+
+    for (size_t k = 0; k < NumChunks(); k++)
+    {
+        vec.insert(vec.end(), ChunkData(k), ChunkData(k) + ChunkLength(k));
+    }
+
+    return vec;
+}
+
+TrajectoryRecorder::TrajectoryRecorder()
+    : TrajectoryRecorder(ChannelSet::All())
+{
+}
+
+TrajectoryRecorder::TrajectoryRecorder(ChannelSet _channels)
+{
+    channels = _channels;
+    channel_list = channels.List();
+
+    for (int ch = 0; ch < max_channels; ch++)
+    {
+        column_index[ch] = -1;
+    }
+
+    for (size_t i = 0; i < channel_list.size(); i++)
+    {
+        column_index[channel_list[i]] = (int)i;
+    }
+
+    size = 0;
+    stream = nullptr;
+}
+
+const ChannelSet &TrajectoryRecorder::Channels() const
+{
+    return channels;
+}
+
+const std::vector<int> &TrajectoryRecorder::ChannelList() const
+{
+    return channel_list;
+}
+
+void TrajectoryRecorder::Reserve(size_t samples)
+{
+    size_t needed = (samples + chunk_size - 1) / chunk_size;
+
+    chunks.reserve(needed);
+
+    while (chunks.size() < needed)
+    {
+        chunks.emplace_back(chunk_size * channel_list.size());
+    }
+}
+
+size_t TrajectoryRecorder::EstimateCapacity(const Params &p)
+{
+    float step = p.sim.outputStep > 0 ? p.sim.outputStep : p.env.dt;
+
+    // Burnout velocity from the rocket equation less gravity losses
+    float avg_mass_flow_rate = (p.engine.avg_thrust / g_0) / p.engine.isp;
+    float prop_mass = (avg_mass_flow_rate * p.engine.burn_time) / (1 - p.fuel.fuelReserve / 100);
+    float wet_mass = p.dryMass + prop_mass;
+    float burnout_mass = wet_mass - avg_mass_flow_rate * p.engine.burn_time;
+    float v_burnout = fmax(g_0 * p.engine.isp * log(wet_mass / burnout_mass) - g_0 * p.engine.burn_time, 0.0f);
+
+    // Drag-free coast up and back down bounds the unpowered flight
+    float apogee = p.engine.burn_time * v_burnout / 2 + pow(v_burnout, 2) / (2 * g_0);
+    float flight_time = p.engine.burn_time + 2 * v_burnout / g_0;
+
+    // Descent under canopy at sea level terminal velocity
+    float cda = p.aero.cd * p.aero.cs_area + p.recovery.drogue_cd * p.recovery.drogue_area;
+
+    if (p.recovery.drogue_area > 0)
+    {
+        flight_time += apogee / sqrt(2 * burnout_mass * g_0 / (air_rho_0 * cda));
+    }
+
+    if (p.recovery.main_area > 0)
+    {
+        cda += p.recovery.main_cd * p.recovery.main_area;
+        flight_time += p.recovery.main_altitude / sqrt(2 * burnout_mass * g_0 / (air_rho_0 * cda));
+    }
+
+    return (size_t)(1.1f * flight_time / step) + 1;
+}
+
+void TrajectoryRecorder::SetStream(StreamWriter *_stream)
+{
+    stream = _stream;
+}
+
+void TrajectoryRecorder::Record(const SimSample &s)
+{
+    if (stream)
+    {
+        stream->Write(s);
+        return;
+    }
+
+    if (size == chunks.size() * chunk_size)
+    {
+        chunks.emplace_back(chunk_size * channel_list.size());
+    }
+
+    float *row = chunks[size / chunk_size].data() + size % chunk_size;
+
+    for (size_t i = 0; i < channel_list.size(); i++)
+    {
+        row[i * chunk_size] = s[channel_list[i]];
+    }
+
+    size++;
+}
+
+void TrajectoryRecorder::Clear()
+{
+    chunks.clear();
+    size = 0;
+}
+
+size_t TrajectoryRecorder::Size() const
+{
+    return size;
+}
+
+ColumnView TrajectoryRecorder::Column(int ch) const
+{
+    if (ch < 0 || ch >= max_channels || column_index[ch] < 0)
+    {
+        return ColumnView(&chunks, 0, 0);
+    }
+
+    return ColumnView(&chunks, column_index[ch] * chunk_size, size);
+}
+
+TrajectoryRecorder::~TrajectoryRecorder()
+{
+}
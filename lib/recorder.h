@@ -0,0 +1,146 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef RECORDER_H_
+#define RECORDER_H_
+
+#include <vector>
+#include "types.h"
+
+#include <string>
+#include <stdint.h>
+
+class StreamWriter;
+
+struct ChannelInfo
+{
+    std::string name;
+    std::string unit;
+};
+
+/*
+* Channels are identified by index into a process wide registry, which starts
+* with the built-in channels. Further channels, such as the 6DOF attitude,
+* angular rates and angle of attack, register by name during setup.
+* Registering an existing name returns its index.
+*/
+int RegisterChannel(std::string name, std::string unit);
+int FindChannel(std::string name);
+int NumChannels();
+// By value, as other threads may be registering channels
+ChannelInfo GetChannelInfo(int ch);
+
+// Set of channels subscribed to by a recorder
+class ChannelSet
+{
+private:
+    uint32_t mask;
+
+public:
+    ChannelSet();
+
+    // Every channel registered so far
+    static ChannelSet All();
+
+    // Channels by name, all channels for an empty list
+    static ChannelSet FromNames(const std::vector<std::string> &names);
+
+    void Add(int ch);
+    bool Contains(int ch) const;
+    std::vector<int> List() const;
+};
+
+/*
+* Read-only view of one recorded channel. Samples are stored in fixed size
+* chunks, each of which is contiguous in memory.
+*/
+class ColumnView
+{
+private:
+    const std::vector<std::vector<float>> *chunks;
+    size_t offset;
+    size_t size;
+
+public:
+    ColumnView(const std::vector<std::vector<float>> *_chunks, size_t _offset, size_t _size);
+
+    size_t Size() const;
+    float operator[](size_t i) const;
+
+    size_t NumChunks() const;
+    const float *ChunkData(size_t k) const;
+    size_t ChunkLength(size_t k) const;
+
+    std::vector<float> ToVector() const;
+};
+
+/*
+* Columnar trajectory storage. Channels live side by side in fixed size
+* chunks, so growth allocates a new chunk rather than copying the samples
+* already recorded, and memory use follows the sample count. Only subscribed
+* channels are stored.
+*/
+class TrajectoryRecorder
+{
+private:
+    // Subscribed channels, and the column each occupies within a chunk
+    ChannelSet channels;
+    std::vector<int> channel_list;
+    int column_index[max_channels];
+
+    // Each chunk holds chunk_size samples of every column, column by column
+    std::vector<std::vector<float>> chunks;
+    size_t size;
+
+    // Samples go here instead of the chunks while streaming
+    StreamWriter *stream;
+
+public:
+    static const size_t chunk_size = 4096;
+
+    TrajectoryRecorder();
+
+    TrajectoryRecorder(ChannelSet _channels);
+
+    const ChannelSet &Channels() const;
+    const std::vector<int> &ChannelList() const;
+
+    // Allocate chunks for the given number of samples ahead of the run
+    void Reserve(size_t samples);
+
+    // Upper estimate of the samples a flight will record
+    static size_t EstimateCapacity(const Params &p);
+
+    // Stream samples to a writer rather than keeping them, null to stop
+    void SetStream(StreamWriter *_stream);
+
+    void Record(const SimSample &s);
+    void Clear();
+
+    size_t Size() const;
+    // Empty view for channels that are not subscribed
+    ColumnView Column(int ch) const;
+
+    ~TrajectoryRecorder();
+};
+
+#endif
@@ -0,0 +1,174 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#include "recordingpolicy.h"
+#include <math.h>
+#include <iostream>
+
+RecordingPolicy::RecordingPolicy()
+{
+    interval = 0.0f;
+    window_before = 0.0f;
+    window_after = 0.0f;
+    has_last = false;
+}
+
+RecordingPolicy::RecordingPolicy(RecordingParameters p)
+{
+    interval = p.interval;
+    window_before = p.event_window_before;
+    window_after = p.event_window_after;
+
+    // A window reaching back before the event cannot be negative
+    if (window_before < 0 || window_after < 0)
+    {
+        std::cout << "Error: Negative event window, clamping to zero" << std::endl;
+        window_before = fmax(window_before, 0.0f);
+        window_after = fmax(window_after, 0.0f);
+    }
+
+    for (size_t i = 0; i < p.deadband.size(); i++)
+    {
+        int ch = FindChannel(p.deadband[i].channel);
+
+        if (ch < 0)
+        {
+            std::cout << "Error: Unknown deadband channel " << p.deadband[i].channel << std::endl;
+            continue;
+        }
+
+        deadband_channels.push_back(ch);
+        deadband_thresholds.push_back(p.deadband[i].threshold);
+    }
+
+    has_last = false;
+}
+
+bool RecordingPolicy::InWindow(float t)
+{
+    // Windows are opened in time order, so closed ones drop off the front
+    while (!window_ends.empty() && window_ends.front() < t)
+    {
+        window_starts.pop_front();
+        window_ends.pop_front();
+    }
+
+    for (size_t i = 0; i < window_starts.size(); i++)
+    {
+        if (t >= window_starts[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool RecordingPolicy::Due(const SimSample &s)
+{
+    if (!has_last || InWindow(s[CH_T]))
+    {
+        return true;
+    }
+
+    if (interval <= 0 && deadband_channels.empty())
+    {
+        return true;
+    }
+
+    if (interval > 0 && s[CH_T] - last[CH_T] >= interval)
+    {
+        return true;
+    }
+
+    for (size_t i = 0; i < deadband_channels.size(); i++)
+    {
+        int ch = deadband_channels[i];
+
+        if (fabs(s[ch] - last[ch]) > deadband_thresholds[i])
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RecordingPolicy::Decide(const SimSample &s, TrajectoryRecorder &output)
+{
+    if (Due(s))
+    {
+        output.Record(s);
+        last = s;
+        has_last = true;
+    }
+}
+
+void RecordingPolicy::Offer(const SimSample &s, TrajectoryRecorder &output)
+{
+    pending.push_back(s);
+
+    while (!pending.empty() && pending.front()[CH_T] < s[CH_T] - window_before)
+    {
+        Decide(pending.front(), output);
+        pending.pop_front();
+    }
+
+    if (window_before <= 0 && !pending.empty())
+    {
+        Decide(pending.front(), output);
+        pending.pop_front();
+    }
+}
+
+void RecordingPolicy::OnEvent(const FlightEvent &e, TrajectoryRecorder &)
+{
+    if (window_before > 0 || window_after > 0)
+    {
+        window_starts.push_back(e.t - window_before);
+        window_ends.push_back(e.t + window_after);
+    }
+}
+
+void RecordingPolicy::Finish(TrajectoryRecorder &output)
+{
+    while (!pending.empty())
+    {
+        SimSample s = pending.front();
+        pending.pop_front();
+
+        if (pending.empty() && !(has_last && last[CH_T] == s[CH_T]))
+        {
+            output.Record(s);
+            last = s;
+            has_last = true;
+        }
+        else
+        {
+            Decide(s, output);
+        }
+    }
+}
+
+RecordingPolicy::~RecordingPolicy()
+{
+}
@@ -0,0 +1,81 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef RECORDINGPOLICY_H_
+#define RECORDINGPOLICY_H_
+
+#include <deque>
+#include <vector>
+#include "types.h"
+#include "recorder.h"
+
+/*
+* Decides which samples reach the recorder. A sample is kept when any of the
+* configured rules fires:
+*   - decimation, at most one sample per interval
+*   - deadband, a channel moved more than its threshold since the last sample
+*   - event window, every sample within a window around ignition, burnout,
+*     apogee, deployments and landing
+* With no rules configured every sample is kept. Samples pass through a delay
+* line as long as the window before an event, so the decision on each one is
+* made once any event close after it is known.
+*/
+class RecordingPolicy
+{
+private:
+    float interval;
+    std::vector<int> deadband_channels;
+    std::vector<float> deadband_thresholds;
+    float window_before;
+    float window_after;
+
+    // Last recorded sample, and whether there has been one
+    SimSample last;
+    bool has_last;
+
+    // Samples awaiting a decision
+    std::deque<SimSample> pending;
+
+    // Open event windows as start and end times
+    std::deque<float> window_starts;
+    std::deque<float> window_ends;
+
+    bool InWindow(float t);
+    bool Due(const SimSample &s);
+    void Decide(const SimSample &s, TrajectoryRecorder &output);
+
+public:
+    RecordingPolicy();
+
+    RecordingPolicy(RecordingParameters p);
+
+    void Offer(const SimSample &s, TrajectoryRecorder &output);
+    void OnEvent(const FlightEvent &e, TrajectoryRecorder &output);
+
+    // Flush the delay line, keeping the final sample so the end of the
+    // flight is always recorded
+    void Finish(TrajectoryRecorder &output);
+
+    ~RecordingPolicy();
+};
+
+#endif
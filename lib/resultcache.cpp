@@ -0,0 +1,486 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "resultcache.h"
+#include "trajectoryfile.h"
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include <string.h>
+#include <stdio.h>
+
+namespace fs = std::filesystem;
+
+// Appends values to a key in a fixed layout
+class KeyWriter
+{
+private:
+    std::string bytes;
+
+public:
+    void Bytes(const void *data, size_t length)
+    {
+        bytes.append((const char *)data, length);
+    }
+
+    void Int(int64_t value)
+    {
+        Bytes(&value, sizeof(value));
+    }
+
+    // By bit pattern, with one zero and one NaN
+    void Float(float value)
+    {
+        if (value == 0.0f)
+        {
+            value = 0.0f;
+        }
+
+        uint32_t bits;
+        memcpy(&bits, &value, sizeof(bits));
+
+        if (isnan(value))
+        {
+            bits = 0x7fc00000;
+        }
+
+        Bytes(&bits, sizeof(bits));
+    }
+
+    void Vector(const Eigen::Vector3f &v)
+    {
+        Float(v.x());
+        Float(v.y());
+        Float(v.z());
+    }
+
+    void Floats(const std::vector<float> &values)
+    {
+        Int(values.size());
+
+        for (size_t i = 0; i < values.size(); i++)
+        {
+            Float(values[i]);
+        }
+    }
+
+    // Length prefixed, so adjacent strings cannot run together
+    void String(const std::string &s)
+    {
+        Int(s.size());
+        Bytes(s.data(), s.size());
+    }
+
+    const std::string &Result() const
+    {
+        return bytes;
+    }
+};
+
+ResultCache::ResultCache(const CacheParameters &_config)
+{
+    config = _config;
+}
+
+bool ResultCache::Enabled() const
+{
+    static const char dirty[] = "-dirty";
+    size_t length = strlen(ROCKETSIM_VERSION);
+    size_t suffix = sizeof(dirty) - 1;
+
+    if (length >= suffix && strcmp(ROCKETSIM_VERSION + length - suffix, dirty) == 0)
+    {
+        return false;
+    }
+
+    return !config.directory.empty() && length > 0;
+}
+
+std::string ResultCache::Key(const Params &p, const ThrustCurve &curve)
+{
+    KeyWriter w;
+
+    w.String(ROCKETSIM_VERSION);
+    w.Int(result_cache_version);
+
+    // Engine
+    w.String(p.engine.type);
+    w.Float(p.engine.mass);
+    w.Vector(p.engine.com);
+    w.Vector(p.engine.rel_pos);
+    w.Vector(p.engine.moi);
+    w.Vector(p.engine.rel_rot);
+    w.Float(p.engine.isp);
+    w.Float(p.engine.avg_thrust);
+    w.Float(p.engine.burn_time);
+    w.Vector(p.engine.cot);
+    w.Vector(p.engine.gimbal);
+    w.Floats(p.engine.gimbal_limits);
+    w.Float(p.engine.delay);
+    w.Float(p.engine.diameter);
+    w.Float(p.engine.length);
+    w.Float(p.engine.prop_mass);
+
+    // Thrust curve contents rather than the file it came from
+    w.Floats(curve.thrust_curve_x);
+    w.Floats(curve.thrust_curve_y);
+
+    // Vehicle
+    w.Float(p.fuel.ofMixtureRatio);
+    w.Float(p.fuel.fuelReserve);
+    w.Float(p.dryMass);
+    w.Vector(p.com);
+    w.Vector(p.cop);
+    w.Vector(p.moi);
+    w.Float(p.aero.cd);
+    w.Float(p.aero.cs_area);
+
+    // Recovery
+    w.Float(p.recovery.drogue_cd);
+    w.Float(p.recovery.drogue_area);
+    w.Float(p.recovery.drogue_delay);
+    w.Float(p.recovery.main_cd);
+    w.Float(p.recovery.main_area);
+    w.Float(p.recovery.main_altitude);
+
+    // Environment, with the atmosphere tables behind it
+    w.Float(p.env.elevation);
+    w.Float(p.env.latitude);
+    w.Float(p.env.longitude);
+    w.Float(p.env.dt);
+    w.Float(p.env.g_0);
+    w.Float(p.env.air_molar_mass);
+    w.Float(p.env.gas_constant);
+    w.Float(p.env.air_gamma);
+    w.Float(p.env.atmo_pressure);
+    w.Float(p.env.wind_speed);
+    w.Float(p.env.wind_exponent);
+    w.Float(p.env.launch_angle);
+    w.Floats(hb);
+    w.Floats(pb);
+    w.Floats(tb);
+    w.Floats(lm);
+
+    // Integration and output
+    w.Float(p.sim.outputStep);
+    w.Int(p.sim.channels.size());
+    for (size_t i = 0; i < p.sim.channels.size(); i++)
+    {
+        w.String(p.sim.channels[i]);
+    }
+    w.Float(p.sim.coastDynamicPressure);
+    w.Float(p.sim.coastStep);
+    w.Float(p.sim.descentMaxDrop);
+    w.Float(p.sim.descentTolerance);
+    w.Int(p.sim.recordOutput && !p.sim.streamOutput);
+
+    w.Float(p.recording.interval);
+    w.Int(p.recording.deadband.size());
+    for (size_t i = 0; i < p.recording.deadband.size(); i++)
+    {
+        w.String(p.recording.deadband[i].channel);
+        w.Float(p.recording.deadband[i].threshold);
+    }
+    w.Float(p.recording.event_window_before);
+    w.Float(p.recording.event_window_after);
+
+    return w.Result();
+}
+
+uint64_t ResultCache::Hash(const std::string &key)
+{
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325ull;
+
+    for (size_t i = 0; i < key.size(); i++)
+    {
+        hash ^= (uint8_t)key[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+std::string ResultCache::EntryPath(const std::string &key, const char *extension) const
+{
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx%s", (unsigned long long)Hash(key), extension);
+
+    return (fs::path(config.directory) / name).string();
+}
+
+static void WritePeak(std::ofstream &file, const SummaryPeak &peak)
+{
+    file.write((const char *)&peak, sizeof(peak));
+}
+
+static void ReadPeak(std::ifstream &file, SummaryPeak &peak)
+{
+    file.read((char *)&peak, sizeof(peak));
+}
+
+template <typename T>
+static void WriteValue(std::ofstream &file, const T &value)
+{
+    file.write((const char *)&value, sizeof(value));
+}
+
+template <typename T>
+static void ReadValue(std::ifstream &file, T &value)
+{
+    file.read((char *)&value, sizeof(value));
+}
+
+bool ResultCache::Load(const std::string &key, CachedResult &result) const
+{
+    if (!Enabled())
+    {
+        return false;
+    }
+
+    std::string path = EntryPath(key, ".res");
+    std::ifstream file(path, std::ios::binary);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    char magic[8];
+    uint32_t version = 0;
+    uint64_t key_length = 0;
+
+    file.read(magic, sizeof(magic));
+    ReadValue(file, version);
+    ReadValue(file, key_length);
+
+    if (!file || memcmp(magic, result_cache_magic, sizeof(magic)) != 0 || version != result_cache_version || key_length != key.size())
+    {
+        return false;
+    }
+
+    std::string stored(key_length, '\0');
+    file.read(&stored[0], key_length);
+
+    if (!file || stored != key)
+    {
+        return false;
+    }
+
+    FlightSummary &s = result.summary;
+    s.Reset();
+
+    ReadPeak(file, s.apogee);
+    ReadPeak(file, s.max_vel);
+    ReadPeak(file, s.max_mach);
+    ReadPeak(file, s.max_acc);
+    ReadPeak(file, s.max_q);
+    ReadValue(file, s.burnt_out);
+    ReadValue(file, s.burnout_time);
+    ReadValue(file, s.burnout_asl);
+    ReadValue(file, s.burnout_vel);
+    ReadValue(file, s.landed);
+    ReadValue(file, s.impact_time);
+    ReadValue(file, s.impact_vel);
+    ReadValue(file, s.impact_downrange);
+
+    uint32_t num_events = 0;
+    uint8_t has_trajectory = 0;
+
+    ReadValue(file, num_events);
+    result.events.resize(std::min(num_events, (uint32_t)max_flight_events));
+    for (size_t i = 0; i < result.events.size(); i++)
+    {
+        ReadValue(file, result.events[i]);
+    }
+    ReadValue(file, has_trajectory);
+
+    if (!file)
+    {
+        return false;
+    }
+
+    result.trajectory.clear();
+
+    if (has_trajectory)
+    {
+        result.trajectory = EntryPath(key, ".trj");
+
+        // Evicted or removed by hand, so the entry is incomplete
+        if (!fs::exists(result.trajectory))
+        {
+            return false;
+        }
+    }
+
+    // Recently used entries are the last to be evicted
+    std::error_code error;
+    fs::last_write_time(path, fs::file_time_type::clock::now(), error);
+
+    return true;
+}
+
+bool ResultCache::Store(const std::string &key, const System &s) const
+{
+    const Params &p = s.Parameters();
+    bool recorded = p.sim.recordOutput && !p.sim.streamOutput;
+
+    return Store(key, s.summary, s.events, recorded ? &s.output : nullptr);
+}
+
+bool ResultCache::Store(const std::string &key, const FlightSummary &summary, const std::vector<FlightEvent> &events,
+                        const TrajectoryRecorder *trajectory) const
+{
+    if (!Enabled())
+    {
+        return false;
+    }
+
+    std::error_code error;
+    fs::create_directories(config.directory, error);
+
+    // Trajectory first, so an entry is never visible without it
+    if (trajectory && !WriteTrajectoryFile(*trajectory, EntryPath(key, ".trj")))
+    {
+        return false;
+    }
+
+    // Written aside and renamed, so readers never see part of an entry
+    std::string path = EntryPath(key, ".res");
+    std::string temp = path + ".tmp";
+
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+
+        if (!file)
+        {
+            return false;
+        }
+
+        uint64_t key_length = key.size();
+
+        file.write(result_cache_magic, sizeof(result_cache_magic));
+        WriteValue(file, result_cache_version);
+        WriteValue(file, key_length);
+        file.write(key.data(), key.size());
+
+        WritePeak(file, summary.apogee);
+        WritePeak(file, summary.max_vel);
+        WritePeak(file, summary.max_mach);
+        WritePeak(file, summary.max_acc);
+        WritePeak(file, summary.max_q);
+        WriteValue(file, summary.burnt_out);
+        WriteValue(file, summary.burnout_time);
+        WriteValue(file, summary.burnout_asl);
+        WriteValue(file, summary.burnout_vel);
+        WriteValue(file, summary.landed);
+        WriteValue(file, summary.impact_time);
+        WriteValue(file, summary.impact_vel);
+        WriteValue(file, summary.impact_downrange);
+
+        uint32_t num_events = std::min(events.size(), (size_t)max_flight_events);
+        uint8_t has_trajectory = trajectory != nullptr;
+
+        WriteValue(file, num_events);
+        for (uint32_t i = 0; i < num_events; i++)
+        {
+            WriteValue(file, events[i]);
+        }
+        WriteValue(file, has_trajectory);
+
+        if (!file)
+        {
+            return false;
+        }
+    }
+
+    fs::rename(temp, path, error);
+
+    return !error;
+}
+
+void ResultCache::Trim() const
+{
+    if (!Enabled())
+    {
+        return;
+    }
+
+    struct Entry
+    {
+        fs::path path;
+        fs::file_time_type time;
+        uintmax_t size;
+    };
+
+    std::vector<Entry> entries;
+    uintmax_t total = 0;
+    std::error_code error;
+
+    for (fs::directory_iterator it(config.directory, error), end; !error && it != end; it.increment(error))
+    {
+        if (it->path().extension() != ".res")
+        {
+            continue;
+        }
+
+        Entry entry;
+        entry.path = it->path();
+        entry.time = fs::last_write_time(entry.path, error);
+        entry.size = fs::file_size(entry.path, error);
+
+        // A trajectory belongs to its summary file and goes with it
+        fs::path trajectory = fs::path(entry.path).replace_extension(".trj");
+        if (fs::exists(trajectory))
+        {
+            entry.size += fs::file_size(trajectory, error);
+        }
+
+        total += entry.size;
+        entries.push_back(entry);
+    }
+
+    uintmax_t budget = (uintmax_t)(config.max_size * 1024.0 * 1024.0);
+
+    if (total <= budget)
+    {
+        return;
+    }
+
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b)
+    {
+        return a.time < b.time;
+    });
+
+    for (size_t i = 0; i < entries.size() && total > budget; i++)
+    {
+        fs::remove(entries[i].path, error);
+        fs::remove(fs::path(entries[i].path).replace_extension(".trj"), error);
+        total -= entries[i].size;
+    }
+}
+
+ResultCache::~ResultCache()
+{
+}
@@ -0,0 +1,98 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef RESULTCACHE_H_
+#define RESULTCACHE_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "types.h"
+#include "flightsummary.h"
+#include "recorder.h"
+#include "system.h"
+
+/*
+* Source revision the results came from, passed by the build, e.g.
+* -DROCKETSIM_VERSION=\"$(git describe --always --dirty)\". Without it a
+* stored result cannot be told from one made by other code, so the cache
+* stays off. It stays off for a "-dirty" revision too, as every uncommitted
+* edit of the same commit would share that name.
+*/
+#ifndef ROCKETSIM_VERSION
+#define ROCKETSIM_VERSION ""
+#endif
+
+// Bumped whenever the entry layout changes
+const uint32_t result_cache_version = 1;
+const char result_cache_magic[8] = {'R', 'S', 'I', 'M', 'R', 'E', 'S', 0};
+
+struct CachedResult
+{
+    FlightSummary summary;
+    std::vector<FlightEvent> events;
+    // Trajectory file of the run, empty when only the summary was kept
+    std::string trajectory;
+};
+
+/*
+* Content-addressed store of finished runs. The key is a canonical byte
+* encoding of every parameter that affects a run, the thrust curve, the
+* atmosphere tables and the code version, and entries are named by its
+* hash. Entries hold the key itself, so a hash collision is a miss rather
+* than a wrong result. Summaries and events go in one small file and any
+* recorded trajectory in a trajectory file beside it, which opens mapped.
+* Hits refresh an entry's time, and Trim removes the least recently used
+* entries once the directory outgrows its budget.
+*/
+class ResultCache
+{
+private:
+    CacheParameters config;
+
+    std::string EntryPath(const std::string &key, const char *extension) const;
+
+public:
+    ResultCache(const CacheParameters &_config);
+
+    // Needs a directory and a build of a committed revision
+    bool Enabled() const;
+
+    // Output file names, printing and campaign settings are left out
+    static std::string Key(const Params &p, const ThrustCurve &curve);
+    static uint64_t Hash(const std::string &key);
+
+    bool Load(const std::string &key, CachedResult &result) const;
+    // Keeps the trajectory too when the run recorded one
+    bool Store(const std::string &key, const System &s) const;
+    bool Store(const std::string &key, const FlightSummary &summary, const std::vector<FlightEvent> &events,
+               const TrajectoryRecorder *trajectory) const;
+
+    // Evict least recently used entries until the directory fits the budget
+    void Trim() const;
+
+    ~ResultCache();
+};
+
+#endif
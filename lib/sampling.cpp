@@ -0,0 +1,271 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "sampling.h"
+#include "counterrng.h"
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+// Stream of the per-dimension scramble seeds, apart from the input ids
+static const uint32_t sobol_scramble_stream = 0x536f626c;
+
+// Draws of the Latin hypercube jitter and the stratum shuffle
+static const uint32_t lhs_jitter_draw = 1;
+static const uint32_t lhs_shuffle_draw = 2;
+
+/*
+* Primitive polynomial degree, coefficients and initial direction numbers
+* of dimensions 2 onwards, from Joe and Kuo's new-joe-kuo-6.21201 table.
+* Dimension 1 is the van der Corput sequence.
+*/
+struct SobolPolynomial
+{
+    int s;
+    uint32_t a;
+    uint32_t m[5];
+};
+
+static const SobolPolynomial sobol_polynomials[sobol_max_dims - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+    {3, 2, {1, 1, 1}},
+    {4, 1, {1, 1, 3, 3}},
+    {4, 4, {1, 3, 5, 13}},
+    {5, 2, {1, 1, 5, 5, 17}},
+    {5, 4, {1, 1, 5, 5, 5}},
+    {5, 7, {1, 1, 7, 11, 19}},
+    {5, 11, {1, 1, 5, 1, 1}},
+    {5, 13, {1, 1, 1, 3, 11}},
+    {5, 14, {1, 3, 5, 5, 31}},
+};
+
+SamplerType ParseSamplerType(const char *name)
+{
+    if (strcmp(name, "sobol") == 0)
+    {
+        return SAMPLER_SOBOL;
+    }
+    else if (strcmp(name, "latin_hypercube") == 0 || strcmp(name, "lhs") == 0)
+    {
+        return SAMPLER_LATIN_HYPERCUBE;
+    }
+
+    return SAMPLER_RANDOM;
+}
+
+const char *SamplerName(SamplerType type)
+{
+    switch (type)
+    {
+    case SAMPLER_SOBOL:
+        return "sobol";
+    case SAMPLER_LATIN_HYPERCUBE:
+        return "latin_hypercube";
+    default:
+        return "random";
+    }
+}
+
+static inline uint32_t ReverseBits(uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555) | ((x & 0x55555555) << 1);
+    x = ((x >> 2) & 0x33333333) | ((x & 0x33333333) << 2);
+    x = ((x >> 4) & 0x0F0F0F0F) | ((x & 0x0F0F0F0F) << 4);
+    x = ((x >> 8) & 0x00FF00FF) | ((x & 0x00FF00FF) << 8);
+
+    return (x >> 16) | (x << 16);
+}
+
+// Each output bit only depends on the bits below it, as Owen scrambling needs
+static inline uint32_t LaineKarrasPermutation(uint32_t x, uint32_t seed)
+{
+    x += seed;
+    x ^= x * 0x6c50b47c;
+    x ^= x * 0xb82f1e52;
+    x ^= x * 0xc7afe638;
+    x ^= x * 0x8d22f6e6;
+
+    return x;
+}
+
+SobolSequence::SobolSequence(int dims, uint32_t seed)
+{
+    if (dims > sobol_max_dims)
+    {
+        dims = sobol_max_dims;
+    }
+
+    directions.assign(32 * dims, 0);
+    scramble.resize(dims);
+
+    CounterRng rng(seed);
+
+    for (int d = 0; d < dims; d++)
+    {
+        uint32_t *v = &directions[32 * d];
+
+        if (d == 0)
+        {
+            for (int j = 0; j < 32; j++)
+            {
+                v[j] = 1u << (31 - j);
+            }
+        }
+        else
+        {
+            const SobolPolynomial &poly = sobol_polynomials[d - 1];
+
+            for (int j = 0; j < 32; j++)
+            {
+                if (j < poly.s)
+                {
+                    v[j] = poly.m[j] << (31 - j);
+                    continue;
+                }
+
+                v[j] = v[j - poly.s] ^ (v[j - poly.s] >> poly.s);
+
+                for (int k = 1; k < poly.s; k++)
+                {
+                    if ((poly.a >> (poly.s - 1 - k)) & 1)
+                    {
+                        v[j] ^= v[j - k];
+                    }
+                }
+            }
+        }
+
+        scramble[d] = rng.Bits(sobol_scramble_stream, d);
+    }
+}
+
+int SobolSequence::Dims() const
+{
+    return scramble.size();
+}
+
+float SobolSequence::Sample(uint32_t index, int dim) const
+{
+    const uint32_t *v = &directions[32 * dim];
+    uint32_t x = 0;
+
+    for (int j = 0; index != 0; j++, index >>= 1)
+    {
+        if (index & 1)
+        {
+            x ^= v[j];
+        }
+    }
+
+    x = ReverseBits(LaineKarrasPermutation(ReverseBits(x), scramble[dim]));
+
+    return UniformFromBits(x);
+}
+
+DispersionSampler::DispersionSampler(SamplerType _type, uint32_t _seed, int dims, int _total)
+    : sobol(_type == SAMPLER_SOBOL ? dims : 0, _seed)
+{
+    type = _type;
+    seed = _seed;
+    total = _total;
+
+    strata.resize(dims);
+}
+
+SamplerType DispersionSampler::Type() const
+{
+    return type;
+}
+
+bool DispersionSampler::Extensible() const
+{
+    return type != SAMPLER_LATIN_HYPERCUBE;
+}
+
+const std::vector<uint32_t> &DispersionSampler::Strata(int dim) const
+{
+    std::vector<uint32_t> &perm = strata[dim];
+
+    if (perm.empty() && total > 0)
+    {
+        CounterRng rng(seed);
+
+        perm.resize(total);
+        for (int i = 0; i < total; i++)
+        {
+            perm[i] = i;
+        }
+
+        // Fisher-Yates, with the swap drawn by counter so it is reproducible
+        for (int i = total - 1; i > 0; i--)
+        {
+            uint32_t j = ((uint64_t)rng.Bits(dim, i, lhs_shuffle_draw) * (i + 1)) >> 32;
+            std::swap(perm[i], perm[j]);
+        }
+    }
+
+    return perm;
+}
+
+void DispersionSampler::Uniforms(int dim, int first, int n, float *out) const
+{
+    CounterRng rng(seed);
+
+    if (type == SAMPLER_SOBOL)
+    {
+        for (int i = 0; i < n; i++)
+        {
+            out[i] = sobol.Sample(first + i, dim);
+        }
+    }
+    else if (type == SAMPLER_LATIN_HYPERCUBE)
+    {
+        const std::vector<uint32_t> &perm = Strata(dim);
+
+        rng.Uniforms(dim, first, n, out, lhs_jitter_draw);
+
+        // Kept below one, which the stratum index plus jitter can round to.
+        // Points past the design have no stratum and stay plain random ones
+        for (int i = 0; i < n && first + i < total; i++)
+        {
+            out[i] = fminf((perm[first + i] + (double)out[i]) / total, 0x1.fffffep-1f);
+        }
+    }
+    else
+    {
+        rng.Uniforms(dim, first, n, out);
+    }
+}
+
+void DispersionSampler::Normals(int dim, int first, int n, float *out) const
+{
+    Uniforms(dim, first, n, out);
+
+    for (int i = 0; i < n; i++)
+    {
+        out[i] = NormalQuantile(out[i]);
+    }
+}
@@ -0,0 +1,93 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef SAMPLING_H_
+#define SAMPLING_H_
+
+#include <stdint.h>
+#include <vector>
+#include "types.h"
+
+SamplerType ParseSamplerType(const char *name);
+const char *SamplerName(SamplerType type);
+
+// Dimensions with Sobol direction numbers
+const int sobol_max_dims = 13;
+
+/*
+* Sobol sequence with Owen scrambling, using the hash based nested uniform
+* scramble of Laine and Karras with a seed per dimension. Scrambling keeps
+* the net structure, so the first 2^m points still stratify every
+* elementary interval, while making the estimates unbiased. Points are
+* computed directly from their index, so any one can be regenerated.
+*/
+class SobolSequence
+{
+private:
+    std::vector<uint32_t> directions;
+    std::vector<uint32_t> scramble;
+
+public:
+    SobolSequence(int dims, uint32_t seed);
+
+    int Dims() const;
+    // Coordinate dim of point index, in (0, 1)
+    float Sample(uint32_t index, int dim) const;
+};
+
+/*
+* Points of a dispersion campaign in the unit hypercube. Random points are
+* the counter-based draws, so random campaigns match CounterRng::Uniform.
+* Latin hypercube designs split each dimension into as many strata as there
+* are points and place one point in each, so the design size is fixed up
+* front. Points requested beyond it are random.
+*/
+class DispersionSampler
+{
+private:
+    SamplerType type;
+    uint32_t seed;
+    int total;
+
+    SobolSequence sobol;
+
+    // Stratum of each point, per dimension, built on first use
+    mutable std::vector<std::vector<uint32_t>> strata;
+
+    const std::vector<uint32_t> &Strata(int dim) const;
+
+public:
+    DispersionSampler(SamplerType _type, uint32_t _seed, int dims, int _total);
+
+    SamplerType Type() const;
+    // Sobol campaigns can stop early, Latin hypercube designs cannot
+    bool Extensible() const;
+
+    // Coordinate dim of points first to first + n
+    void Uniforms(int dim, int first, int n, float *out) const;
+    // As above, transformed to standard normal deviates
+    void Normals(int dim, int first, int n, float *out) const;
+};
+
+#endif
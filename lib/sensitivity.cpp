@@ -0,0 +1,91 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#include "sensitivity.h"
+#include "simulator.h"
+
+typedef Dual<SENS_COUNT> SensDual;
+
+static SensitivityValue ToSensitivityValue(const SensDual &x)
+{
+    SensitivityValue out;
+
+    out.value = x.v;
+    for (int i = 0; i < SENS_COUNT; i++)
+    {
+        out.gradient[i] = x.d[i];
+    }
+
+    return out;
+}
+
+SensitivityResult CalculateSensitivities(Params p, ThrustCurve curve)
+{
+    typedef SingleSolidMotorT<SensDual> Vehicle;
+
+    Vehicle vehicle(p, curve);
+
+    vehicle.cd = SensDual::Variable(p.aero.cd, SENS_CD);
+    vehicle.dry_mass = SensDual::Variable(p.dryMass, SENS_DRY_MASS);
+    vehicle.thrust_scale = SensDual::Variable(1.0f, SENS_THRUST_SCALE);
+    vehicle.wind_speed = SensDual::Variable(p.env.wind_speed, SENS_WIND_SPEED);
+
+    SensDual apogee;
+    SensDual max_q;
+    Vehicle::State last;
+
+    // Extrema are taken at the step where they occur, where the envelope
+    // theorem makes the state derivatives the derivatives of the extremum
+    auto track = [&](const Vehicle::State &s, const Vehicle::Derivative &d)
+    {
+        SensDual q = 0.5f * d.vars.density * s.vel * s.vel;
+
+        if (s.altitude > apogee)
+        {
+            apogee = s.altitude;
+        }
+
+        if (q > max_q)
+        {
+            max_q = q;
+        }
+
+        last = s;
+    };
+
+    Simulator<Vehicle, RK4> sim(vehicle, p.env.dt);
+    sim.Propagate(track);
+
+    // Locate the ground crossing within the final step
+    SensDual below = (last.altitude - vehicle.Elevation()) / last.vel;
+    SensDual impact_time = last.t - below;
+    SensDual impact_downrange = last.downrange - last.vel_x * below;
+
+    SensitivityResult result;
+
+    result.apogee = ToSensitivityValue(apogee);
+    result.max_q = ToSensitivityValue(max_q);
+    result.ballistic_impact_time = ToSensitivityValue(impact_time);
+    result.ballistic_impact_downrange = ToSensitivityValue(impact_downrange);
+
+    return result;
+}
@@ -0,0 +1,64 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef SENSITIVITY_H_
+#define SENSITIVITY_H_
+
+#include "types.h"
+#include "dual.h"
+#include "vehicle.h"
+
+// Inputs the trajectory is differentiated against
+enum SensitivityInput
+{
+    SENS_CD,
+    SENS_DRY_MASS,
+    SENS_THRUST_SCALE,
+    SENS_WIND_SPEED,
+    SENS_COUNT
+};
+
+// A trajectory output and its partial derivatives with respect to each input
+struct SensitivityValue
+{
+    float value;
+    float gradient[SENS_COUNT];
+};
+
+struct SensitivityResult
+{
+    SensitivityValue apogee;
+    SensitivityValue max_q;
+    // Of the unrecovered vehicle, not the parachute landing System flies to
+    SensitivityValue ballistic_impact_time;
+    SensitivityValue ballistic_impact_downrange;
+};
+
+/*
+* Runs one simulation of the burn and coast SingleSolidMotorT model in Dual
+* arithmetic and returns exact derivatives of the key outputs, replacing one
+* finite difference run per input. Apogee and max q follow System for a
+* vertical launch, as the launch angle and recovery are left out.
+*/
+SensitivityResult CalculateSensitivities(Params p, ThrustCurve curve = ThrustCurve());
+
+#endif
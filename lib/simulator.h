@@ -0,0 +1,108 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef SIMULATOR_H_
+#define SIMULATOR_H_
+
+#include "types.h"
+#include "vehicle.h"
+#include "integrators.h"
+#include "denseoutput.h"
+
+/*
+* Simulation core specialised at compile time on the vehicle model and the
+* integration policy, e.g. Simulator<SingleSolidMotor, RK4>. System remains
+* the runtime-dispatched path for arbitrary configurations.
+*/
+template <typename Vehicle, typename Integrator>
+class Simulator
+{
+private:
+    Vehicle vehicle;
+    float dt;
+
+    DenseOutput dense_output;
+
+public:
+    TrajectoryRecorder output;
+
+    Simulator(Vehicle _vehicle, float _dt, float output_step = 0.0f)
+        : vehicle(_vehicle), dt(_dt), dense_output(output_step)
+    {
+    }
+
+    void SetOutputTimes(std::vector<float> times)
+    {
+        dense_output = DenseOutput(times);
+    }
+
+    /*
+    * Integrate to landing, passing each state and its derivative to the
+    * observer. The derivative is the one the next step starts from.
+    */
+    template <typename Observer>
+    void Propagate(Observer &observer)
+    {
+        typename Vehicle::State state = vehicle.InitialState();
+        typename Vehicle::Derivative d = vehicle.Evaluate(state);
+
+        observer(state, d);
+
+        while (!vehicle.Landed(state))
+        {
+            // Shorten the step to land on discontinuities such as burnout
+            float h = fminf(dt, vehicle.NextEvent(state.t) - state.t);
+
+            Integrator::Step(vehicle, state, d, h);
+
+            d = vehicle.Evaluate(state);
+            observer(state, d);
+        }
+    }
+
+    void RunSimulation()
+    {
+        bool first = true;
+        SimSample prev;
+
+        auto record = [&](const typename Vehicle::State &state, const typename Vehicle::Derivative &d)
+        {
+            SimSample curr = vehicle.Sample(state, d);
+
+            if (first)
+            {
+                dense_output.Begin(curr, output);
+                first = false;
+            }
+            else
+            {
+                dense_output.Advance(prev, curr, output);
+            }
+
+            prev = curr;
+        };
+
+        Propagate(record);
+    }
+};
+
+#endif
@@ -0,0 +1,214 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#include "sobolindices.h"
+#include "resultcache.h"
+#include <iostream>
+#include <algorithm>
+#include <vector>
+#include <math.h>
+
+void RunningMean::Add(double x)
+{
+    n++;
+    double delta = x - mean;
+    mean += delta / n;
+    m2 += delta * (x - mean);
+}
+
+double RunningMean::Error() const
+{
+    return n > 1 ? sqrt(m2 / (n - 1) / n) : INFINITY;
+}
+
+SensitivityAnalysis::SensitivityAnalysis(const Params &_base)
+{
+    base = _base;
+    config = base.monte_carlo;
+    rows = 0;
+    utilisation = 0.0;
+
+    std::fill(shift, shift + MC_OUTPUT_COUNT, 0.0);
+}
+
+void SensitivityAnalysis::Run()
+{
+    int total_rows = std::max(config.runs, 0);
+
+    // A takes the first DISP_COUNT dimensions and B the next
+    DispersionSampler sampler(config.sampler, config.seed, 2 * DISP_COUNT, total_rows);
+
+    const int stride = DISP_COUNT + 2;
+    std::vector<MonteCarloRun> block(block_rows * stride);
+    std::vector<float> z(block_rows);
+
+    for (int first = 0; first < total_rows; first += block_rows)
+    {
+        int n = std::min(block_rows, total_rows - first);
+
+        // Runs of a row are A, B, then AB_i for each input
+        for (int d = 0; d < 2 * DISP_COUNT; d++)
+        {
+            sampler.Normals(d, first, n, z.data());
+
+            int matrix = d / DISP_COUNT;
+            int input = d % DISP_COUNT;
+
+            for (int i = 0; i < n; i++)
+            {
+                block[i * stride + matrix].z[input] = z[i];
+            }
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            const MonteCarloRun &a = block[i * stride];
+            const MonteCarloRun &b = block[i * stride + 1];
+
+            for (int j = 0; j < DISP_COUNT; j++)
+            {
+                MonteCarloRun &ab = block[i * stride + 2 + j];
+
+                std::copy(a.z, a.z + DISP_COUNT, ab.z);
+                ab.z[j] = b.z[j];
+            }
+        }
+
+        double block_utilisation = SimulateRuns(base, config.threads, block.data(), n * stride);
+
+        rows += n;
+        utilisation += (block_utilisation - utilisation) * n / rows;
+
+        Accumulate(block.data(), n);
+    }
+
+    ResultCache(base.cache).Trim();
+}
+
+void SensitivityAnalysis::Accumulate(const MonteCarloRun *block, int n)
+{
+    const int stride = DISP_COUNT + 2;
+
+    // Products of outputs lose precision far from zero, so centre them
+    if (output[0].n == 0)
+    {
+        for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+        {
+            double sum = 0.0;
+
+            for (int i = 0; i < n; i++)
+            {
+                sum += MonteCarloOutputValue(block[i * stride].summary, k);
+            }
+
+            shift[k] = n > 0 ? sum / n : 0.0;
+        }
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        const MonteCarloRun *row = &block[i * stride];
+
+        for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+        {
+            double fa = MonteCarloOutputValue(row[0].summary, k) - shift[k];
+            double fb = MonteCarloOutputValue(row[1].summary, k) - shift[k];
+
+            output[k].Add(fa);
+            output[k].Add(fb);
+
+            for (int j = 0; j < DISP_COUNT; j++)
+            {
+                double fab = MonteCarloOutputValue(row[2 + j].summary, k) - shift[k];
+
+                first[k][j].Add(fb * (fab - fa));
+                total[k][j].Add(0.5 * (fa - fab) * (fa - fab));
+            }
+        }
+    }
+}
+
+int SensitivityAnalysis::Rows() const
+{
+    return rows;
+}
+
+int SensitivityAnalysis::Runs() const
+{
+    return rows * (DISP_COUNT + 2);
+}
+
+double SensitivityAnalysis::Utilisation() const
+{
+    return utilisation;
+}
+
+double SensitivityAnalysis::Variance(int output_index) const
+{
+    const RunningMean &m = output[output_index];
+    return m.n > 1 ? m.m2 / (m.n - 1) : 0.0;
+}
+
+SensitivityIndex SensitivityAnalysis::Index(int output_index, int input) const
+{
+    SensitivityIndex index = {};
+    double variance = Variance(output_index);
+
+    if (variance <= 0)
+    {
+        return index;
+    }
+
+    const RunningMean &f = first[output_index][input];
+    const RunningMean &t = total[output_index][input];
+
+    index.first = f.mean / variance;
+    index.first_error = f.Error() / variance;
+    index.total = t.mean / variance;
+    index.total_error = t.Error() / variance;
+
+    return index;
+}
+
+void SensitivityAnalysis::PrintSummary() const
+{
+    std::cout << "Sensitivity rows: " << rows << ", " << Runs() << " runs, " << SamplerName(config.sampler) << " sampling" << std::endl;
+
+    for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+    {
+        std::cout << MonteCarloOutputName(k) << ": sd " << sqrt(Variance(k)) << std::endl;
+
+        for (int j = 0; j < DISP_COUNT; j++)
+        {
+            SensitivityIndex index = Index(k, j);
+
+            std::cout << "    " << DispersionName(j) << ": first " << index.first << " +/- " << index.first_error
+                      << ", total " << index.total << " +/- " << index.total_error << std::endl;
+        }
+    }
+}
+
+SensitivityAnalysis::~SensitivityAnalysis()
+{
+}
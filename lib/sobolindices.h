@@ -0,0 +1,101 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+#ifndef SOBOLINDICES_H_
+#define SOBOLINDICES_H_
+
+#include "types.h"
+#include "montecarlo.h"
+
+// Running mean and variance of one estimator term, updated one run at a time
+struct RunningMean
+{
+    long long n = 0;
+    double mean = 0.0;
+    double m2 = 0.0;
+
+    void Add(double x);
+    // Standard error of the mean
+    double Error() const;
+};
+
+// First and total order indices of one output with respect to one input
+struct SensitivityIndex
+{
+    double first;
+    double first_error;
+    double total;
+    double total_error;
+};
+
+/*
+* Variance-based sensitivity of every campaign output to every dispersed
+* input. Each base row draws two independent points A and B from twice as
+* many sampler dimensions as there are inputs, and k more runs that take A
+* with input i swapped in from B. The first order index uses Saltelli's
+* estimator mean(f(B) (f(AB_i) - f(A))) and the total order index Jansen's
+* mean((f(A) - f(AB_i))^2) / 2, both over the output variance, so N rows
+* cost N (k + 2) runs. Rows are simulated a block at a time and folded into
+* running sums, so no run outlives its block.
+*/
+class SensitivityAnalysis
+{
+private:
+    Params base;
+    MonteCarloParameters config;
+
+    int rows;
+    double utilisation;
+
+    // Outputs are shifted by the first block's mean before they are summed
+    double shift[MC_OUTPUT_COUNT];
+
+    RunningMean output[MC_OUTPUT_COUNT];
+    RunningMean first[MC_OUTPUT_COUNT][DISP_COUNT];
+    RunningMean total[MC_OUTPUT_COUNT][DISP_COUNT];
+
+    void Accumulate(const MonteCarloRun *block, int n);
+
+public:
+    // Base rows simulated together, each of DISP_COUNT + 2 runs
+    static const int block_rows = 64;
+
+    SensitivityAnalysis(const Params &_base);
+
+    // Run monte_carlo.runs base rows
+    void Run();
+
+    int Rows() const;
+    int Runs() const;
+    double Utilisation() const;
+
+    double Variance(int output) const;
+    SensitivityIndex Index(int output, int input) const;
+
+    void PrintSummary() const;
+
+    ~SensitivityAnalysis();
+};
+
+#endif
@@ -0,0 +1,96 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef SPSCQUEUE_H_
+#define SPSCQUEUE_H_
+
+#include <atomic>
+#include <vector>
+#include <stddef.h>
+
+/*
+* Bounded lock-free queue for exactly one producer and one consumer thread.
+* Each index is only written by one side, so acquire/release ordering on the
+* indices is enough to publish the slots.
+*/
+template <typename T>
+class SpscQueue
+{
+private:
+    std::vector<T> slots;
+    size_t mask;
+
+    // Kept on separate cache lines so the two threads do not contend
+    alignas(64) std::atomic<size_t> head;
+    alignas(64) std::atomic<size_t> tail;
+
+public:
+    // Capacity is rounded up to a power of two
+    SpscQueue(size_t capacity)
+    {
+        size_t n = 1;
+        while (n < capacity)
+        {
+            n <<= 1;
+        }
+
+        slots.resize(n);
+        mask = n - 1;
+        head = 0;
+        tail = 0;
+    }
+
+    // Producer side, false when full
+    bool Push(const T &value)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+
+        if (t - head.load(std::memory_order_acquire) > mask)
+        {
+            return false;
+        }
+
+        slots[t & mask] = value;
+        tail.store(t + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    // Consumer side, false when empty
+    bool Pop(T &value)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+
+        if (h == tail.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        value = slots[h & mask];
+        head.store(h + 1, std::memory_order_release);
+
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,164 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "streamwriter.h"
+#include "recorder.h"
+#include <iostream>
+#include <chrono>
+
+StreamWriter::StreamWriter()
+    : full(4), empty(4)
+{
+    current = nullptr;
+}
+
+bool StreamWriter::Open(const std::string &filename, const std::vector<int> &_channels,
+                        const std::vector<CsvPrecisionParameter> &digits)
+{
+    Finish();
+
+    channels = _channels;
+
+    if (!csv.Open(filename))
+    {
+        return false;
+    }
+
+    std::vector<std::string> names;
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        names.push_back(GetChannelInfo(channels[c]).name);
+    }
+
+    csv.WriteHeader(names);
+    csv.SetPrecision(channels, digits);
+
+    for (int i = 0; i < 2; i++)
+    {
+        blocks[i].values.resize(block_size * channels.size());
+        blocks[i].size = 0;
+    }
+
+    // A previous stream leaves its blocks queued, drop them so each block
+    // is handed out once
+    Block *stale;
+    while (empty.Pop(stale))
+    {
+    }
+
+    current = &blocks[0];
+    empty.Push(&blocks[1]);
+
+    writer = std::thread(&StreamWriter::Run, this);
+
+    return true;
+}
+
+void StreamWriter::Write(const SimSample &s)
+{
+    if (current == nullptr)
+    {
+        return;
+    }
+
+    float *row = current->values.data() + current->size * channels.size();
+
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        row[c] = s[channels[c]];
+    }
+
+    if (++current->size == block_size)
+    {
+        Submit(current);
+
+        // Wait for the writer to hand back the other block
+        while (!empty.Pop(current))
+        {
+            std::this_thread::yield();
+        }
+        current->size = 0;
+    }
+}
+
+void StreamWriter::Submit(Block *block)
+{
+    while (!full.Push(block))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void StreamWriter::Run()
+{
+    while (true)
+    {
+        Block *block;
+
+        if (!full.Pop(block))
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            continue;
+        }
+
+        // A null block marks the end of the stream
+        if (block == nullptr)
+        {
+            break;
+        }
+
+        const float *row = block->values.data();
+        for (size_t i = 0; i < block->size; i++, row += channels.size())
+        {
+            csv.WriteRow(row);
+        }
+
+        empty.Push(block);
+    }
+
+    csv.Flush();
+}
+
+void StreamWriter::Finish()
+{
+    if (current == nullptr)
+    {
+        return;
+    }
+
+    if (current->size > 0)
+    {
+        Submit(current);
+    }
+    Submit(nullptr);
+
+    writer.join();
+    csv.Close();
+
+    current = nullptr;
+}
+
+StreamWriter::~StreamWriter()
+{
+    Finish();
+}
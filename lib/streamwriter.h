@@ -0,0 +1,86 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef STREAMWRITER_H_
+#define STREAMWRITER_H_
+
+#include <string>
+#include <thread>
+#include <vector>
+#include "types.h"
+#include "spscqueue.h"
+#include "csvwriter.h"
+
+/*
+* Streams recorded samples to a CSV file from a background thread. The
+* simulation fills one block of samples while the writer formats and writes
+* the other, blocks passing between the threads through lock-free queues.
+* Memory use is two blocks however long the flight, and the simulation only
+* waits when the writer falls a whole block behind.
+*/
+class StreamWriter
+{
+private:
+    struct Block
+    {
+        std::vector<float> values;
+        size_t size;
+    };
+
+    std::vector<int> channels;
+    CsvWriter csv;
+
+    Block blocks[2];
+    Block *current;
+
+    // Filled blocks to the writer, and written blocks back for reuse
+    SpscQueue<Block *> full;
+    SpscQueue<Block *> empty;
+
+    std::thread writer;
+
+    void Run();
+    void Submit(Block *block);
+
+    StreamWriter(const StreamWriter &);
+    StreamWriter &operator=(const StreamWriter &);
+
+public:
+    static const size_t block_size = 4096;
+
+    StreamWriter();
+
+    // Write the header and start the writer thread, finishing any stream
+    // already open
+    bool Open(const std::string &filename, const std::vector<int> &_channels,
+              const std::vector<CsvPrecisionParameter> &digits = std::vector<CsvPrecisionParameter>());
+
+    void Write(const SimSample &s);
+
+    // Write out the partial block and wait for the writer to finish
+    void Finish();
+
+    ~StreamWriter();
+};
+
+#endif
@@ -20,10 +20,12 @@
  */
 
 #include "system.h"
+#include <algorithm>
 
 System::System()
 {
-    
+    phase = PHASE_DONE;
+    burn_step = 0;
 }
 
 System::System(Params _params)
@@ -51,12 +53,42 @@ System::System(Params _params)
     cd = p.aero.cd;
     cs_area = p.aero.cs_area;
 
+    // Recovery
+    recovery = p.recovery;
+    past_apogee = false;
+    apogee_time = 0.0f;
+    drogue_deployed = false;
+    main_deployed = false;
+    landed = false;
+
+    // Wind
+    wind_speed = p.env.wind_speed;
+    wind_exponent = p.env.wind_exponent;
+    launch_cos = cos(p.env.launch_angle * pi / 180.0f);
+    launch_sin = sin(p.env.launch_angle * pi / 180.0f);
+
     // Environment
     elevation = p.env.elevation;
     dt = p.env.dt;
     num_steps = floorf(burn_time / dt);
 
+    // Coast
+    coast_q = p.sim.coastDynamicPressure;
+    coast_dt = p.sim.coastStep;
+
+    // Descent
+    descent_drop = p.sim.descentMaxDrop;
+    descent_tolerance = p.sim.descentTolerance;
+
+    // Output
+    ch_aoa = RegisterChannel("AoA", "rad");
+    output = TrajectoryRecorder(ChannelSet::FromNames(p.sim.channels));
+    dense_output = DenseOutput(p.sim.outputStep);
+    policy = RecordingPolicy(p.recording);
+
     // Initalise
+    phase = PHASE_DONE;
+    burn_step = 0;
     t = 0.0f;
     altitude = 0.0f;
     asl = altitude + elevation;
@@ -69,106 +101,512 @@ System::System(Params _params)
     vel = 0.0f;
     mach = 0.0f;
     acc = 0.0f;
+    mass_flow_rate = 0.0f;
+    downrange = 0.0f;
+    vel_x = 0.0f;
+    acc_x = 0.0f;
+}
+
+const Params &System::Parameters() const
+{
+    return p;
+}
+
+void System::SetOutputTimes(std::vector<float> times)
+{
+    dense_output = DenseOutput(times);
 }
 
 void System::RunSimulation()
 {
-    for (int i = 0; i < num_steps; i++)
+    Begin();
+
+    while (Step())
+    {
+    }
+}
+
+void System::Begin()
+{
+    Open();
+
+    summary.Reset();
+
+    prev_sample = CaptureSample();
+    summary.Update(prev_sample);
+
+    if (p.sim.recordOutput)
+    {
+        dense_output.Begin(prev_sample, output);
+    }
+    AddEvent(EVENT_IGNITION, t);
+
+    phase = PHASE_BURN;
+    burn_step = 0;
+}
+
+SystemSnapshot System::Snapshot() const
+{
+    SystemSnapshot snapshot;
+
+    snapshot.phase = phase;
+    snapshot.burn_step = burn_step;
+
+    snapshot.t = t;
+    snapshot.altitude = altitude;
+    snapshot.asl = asl;
+    snapshot.mass = mass;
+    snapshot.propellant_mass = propellant_mass;
+    snapshot.mass_flow_rate = mass_flow_rate;
+    snapshot.avg_thrust = avg_thrust;
+    snapshot.thrust = thrust;
+    snapshot.drag = drag;
+    snapshot.vel = vel;
+    snapshot.mach = mach;
+    snapshot.acc = acc;
+
+    snapshot.downrange = downrange;
+    snapshot.vel_x = vel_x;
+    snapshot.acc_x = acc_x;
+
+    snapshot.past_apogee = past_apogee;
+    snapshot.apogee_time = apogee_time;
+    snapshot.drogue_deployed = drogue_deployed;
+    snapshot.main_deployed = main_deployed;
+    snapshot.landed = landed;
+
+    snapshot.vars = vars;
+    snapshot.prev_sample = prev_sample;
+    snapshot.summary = summary;
+
+    snapshot.event_count = std::min((int)events.size(), max_flight_events);
+    std::copy(events.begin(), events.begin() + snapshot.event_count, snapshot.events);
+
+    return snapshot;
+}
+
+void System::Restore(const SystemSnapshot &snapshot)
+{
+    Open();
+
+    phase = (Phase)snapshot.phase;
+    burn_step = snapshot.burn_step;
+
+    t = snapshot.t;
+    altitude = snapshot.altitude;
+    asl = snapshot.asl;
+    mass = snapshot.mass;
+    propellant_mass = snapshot.propellant_mass;
+    mass_flow_rate = snapshot.mass_flow_rate;
+    avg_thrust = snapshot.avg_thrust;
+    thrust = snapshot.thrust;
+    drag = snapshot.drag;
+    vel = snapshot.vel;
+    mach = snapshot.mach;
+    acc = snapshot.acc;
+
+    downrange = snapshot.downrange;
+    vel_x = snapshot.vel_x;
+    acc_x = snapshot.acc_x;
+
+    past_apogee = snapshot.past_apogee;
+    apogee_time = snapshot.apogee_time;
+    drogue_deployed = snapshot.drogue_deployed;
+    main_deployed = snapshot.main_deployed;
+    landed = snapshot.landed;
+
+    vars = snapshot.vars;
+    prev_sample = snapshot.prev_sample;
+    summary = snapshot.summary;
+
+    events.assign(snapshot.events, snapshot.events + snapshot.event_count);
+
+    if (p.sim.recordOutput)
+    {
+        dense_output.Begin(prev_sample, output);
+    }
+}
+
+// Output set up shared by a fresh run and a restored one
+void System::Open()
+{
+    // Streamed runs hand samples to the writer thread as they are recorded
+    stream.reset();
+
+    if (p.sim.streamOutput)
+    {
+        stream = std::make_shared<StreamWriter>();
+
+        if (!stream->Open(p.sim.csvFilename, output.ChannelList(), p.sim.csvPrecision))
+        {
+            stream.reset();
+        }
+    }
+
+    if (stream)
+    {
+        output.SetStream(stream.get());
+    }
+    else if (p.sim.recordOutput)
+    {
+        output.Reserve(TrajectoryRecorder::EstimateCapacity(p));
+    }
+
+    // Set here rather than on construction, as System may have been copied
+    dense_output.SetPolicy(&policy);
+}
+
+bool System::Step()
+{
+    if (phase == PHASE_BURN)
+    {
+        if (burn_step < num_steps)
+        {
+            BurnStep();
+            burn_step++;
+            return true;
+        }
+
+        avg_thrust = 0;
+        thrust = 0;
+        AddEvent(EVENT_BURNOUT, t);
+
+        phase = PHASE_FLIGHT;
+    }
+
+    if (phase == PHASE_FLIGHT)
+    {
+        if (asl >= elevation && !landed)
+        {
+            FlightStep();
+            return true;
+        }
+
+        Finish();
+
+        phase = PHASE_DONE;
+    }
+
+    return false;
+}
+
+bool System::Done() const
+{
+    return phase == PHASE_DONE;
+}
+
+void System::BurnStep()
+{
+    UpdateEnvironment();
+    CalculateThrust();
+    CalculateAcceleration();
+    CalculateAltitude();
+    CalculateVelocity();
+    CalculateDrift();
+    CalculateDrag();
+    CalculatePropellant();
+    CalculateMass();
+
+    t += dt;
+    RecordStep();
+}
+
+void System::FlightStep()
+{
+    UpdateEnvironment();
+    UpdateRecovery();
+
+    // Near-ballistic arc, switches back once dynamic pressure builds
+    if (InCoastRegime())
+    {
+        CoastStep();
+        RecordStep();
+        return;
+    }
+
+    // Settled under canopy, steps follow the terminal velocity profile.
+    // A step that stays at t would record a second row at the same time.
+    if (InDescentEquilibrium())
+    {
+        if (DescentStep())
+        {
+            RecordStep();
+        }
+        return;
+    }
+
+    CalculateAcceleration();
+    CalculateAltitude();
+    CalculateVelocity();
+    CalculateDrift();
+    CalculateDrag();
+    CalculateMass();
+
+    t += dt;
+    RecordStep();
+}
+
+void System::Finish()
+{
+    AddEvent(EVENT_LANDING, t);
+    policy.Finish(output);
+
+    if (stream)
+    {
+        output.SetStream(nullptr);
+        stream->Finish();
+        stream.reset();
+        std::cout << "Output streamed to " << p.sim.csvFilename << std::endl;
+    }
+
+    if (p.sim.printSummary)
+    {
+        std::cout << "Apogee: " << summary.apogee.value << " at " << summary.apogee.t << std::endl;
+        std::cout << "Peak Velocity: " << summary.max_vel.value << " at " << summary.max_vel.t << std::endl;
+        std::cout << "Peak Velocity (Mach): " << summary.max_mach.value << " at " << summary.max_mach.t << std::endl;
+        std::cout << "Peak Acceleration: " << summary.max_acc.value << " at " << summary.max_acc.t << std::endl;
+        std::cout << "Max Q: " << summary.max_q.value << " at " << summary.max_q.t << std::endl;
+        std::cout << "Burnout: " << summary.burnout_asl << " m, " << summary.burnout_vel << " m/s at " << summary.burnout_time << std::endl;
+        std::cout << "Impact: " << summary.impact_downrange << " m downrange, " << summary.impact_vel << " m/s" << std::endl;
+        std::cout << "Elapsed Time: " << summary.impact_time << std::endl;
+    }
+}
+
+SimSample System::CaptureSample()
+{
+    SimSample sample;
+
+    sample[CH_T] = t;
+    sample[CH_ASL] = asl;
+    sample[CH_VEL] = vel;
+    sample[CH_VEL_MACH] = mach;
+    sample[CH_ACC] = acc;
+    sample[CH_MASS] = mass;
+    sample[CH_MASS_FLOW_RATE] = mass_flow_rate;
+    sample[CH_PROP_MASS] = propellant_mass;
+    sample[CH_THRUST] = thrust;
+    sample[CH_DRAG] = drag;
+    sample[CH_RHO] = vars.density;
+    sample[CH_PRESSURE] = vars.pressure;
+    sample[CH_TEMP] = vars.tempFunc.temp;
+    sample[CH_G] = vars.g;
+    sample[CH_DOWNRANGE] = downrange;
+
+    // Derived channels are only computed when subscribed
+    if (output.Channels().Contains(CH_TWR))
     {
-        UpdateEnvironment();
-        CalculateThrust();
-        CalculateAcceleration();
-        CalculateAltitude();
-        CalculateVelocity();
-        CalculateDrag();
-        CalculateTWR();
-        CalculatePropellant();
-        CalculateMass();
-
-        output.vec_asl.push_back(asl);
-        output.vec_vel.push_back(vel);
-        output.vec_vel_mach.push_back(mach);
-        output.vec_acc.push_back(acc);
-        output.vec_mass.push_back(mass);
-        output.vec_mass_flow_rate.push_back(mass_flow_rate);
-        output.vec_prop_mass.push_back(propellant_mass);
-        output.vec_thrust.push_back(thrust);
-        output.vec_twr.push_back(twr);
-        output.vec_drag.push_back(drag);
-        output.vec_rho.push_back(vars.density);
-        output.vec_pressure.push_back(vars.pressure);
-        output.vec_temp.push_back(vars.tempFunc.temp);
-        output.vec_g.push_back(vars.g);
-        output.vec_t.push_back(t);
-
-        t += dt;
-    }
-
-    avg_thrust = 0;
-    thrust = 0;
-
-    while(asl >= elevation)
-    {
-        UpdateEnvironment();
-        CalculateAcceleration();
-        CalculateAltitude();
-        CalculateVelocity();
-        CalculateDrag();
         CalculateTWR();
-        CalculateMass();
-
-        output.vec_asl.push_back(asl);
-        output.vec_vel.push_back(vel);
-        output.vec_vel_mach.push_back(mach);
-        output.vec_acc.push_back(acc);
-        output.vec_mass.push_back(mass);
-        output.vec_mass_flow_rate.push_back(mass_flow_rate);
-        output.vec_prop_mass.push_back(propellant_mass);
-        output.vec_thrust.push_back(thrust);
-        output.vec_twr.push_back(twr);
-        output.vec_drag.push_back(drag);
-        output.vec_rho.push_back(vars.density);
-        output.vec_pressure.push_back(vars.pressure);
-        output.vec_temp.push_back(vars.tempFunc.temp);
-        output.vec_g.push_back(vars.g);
-        output.vec_t.push_back(t);
-        
-        t += dt;
-    }
-
-    std::cout << "Apogee: " << CalcMaximum(output.vec_asl) << std::endl;
-    std::cout << "Peak Velocity: " << CalcMaximum(output.vec_vel) << std::endl;
-    std::cout << "Peak Velocity (Mach): " << CalcMaximum(output.vec_vel_mach) << std::endl;
-    std::cout << "Peak Acceleration: " << CalcMaximum(output.vec_acc) << std::endl;
-    std::cout << "Elapsed Time: " << CalcMaximum(output.vec_t) << std::endl;
-    
-    plt::figure(1);
-    plt::xlabel("t (s)");
-    plt::ylabel("Alt (m)");
-    plt::plot(output.vec_t, output.vec_asl);
-    plt::figure(2);
-    plt::xlabel("t (s)");
-    plt::ylabel("Vel (m/s)");
-    plt::plot(output.vec_t, output.vec_vel,"r");
-    plt::figure(3);
-    plt::xlabel("t (s)");
-    plt::ylabel("Vel (Mach)");
-    plt::plot(output.vec_t, output.vec_acc, "b");
-    plt::figure(4);
-    plt::xlabel("t (s)");
-    plt::ylabel("Mass (kg)");
-    plt::plot(output.vec_t, output.vec_mass,"g");
-    plt::figure(5);
-    plt::xlabel("t (s)");
-    plt::ylabel("Drag (N)");
-    plt::plot(output.vec_t, output.vec_drag,"o");
-    plt::figure(6);
-    plt::xlabel("t (s)");
-    plt::ylabel("Atmospheric Density (kg/m^3)");
-    plt::plot(output.vec_t, output.vec_rho, "p");
-
-    plt::show();
+        sample[CH_TWR] = twr;
+    }
+
+    if (output.Channels().Contains(ch_aoa))
+    {
+        // Body axis is held vertical, so the angle of attack follows from the
+        // wind-relative horizontal airspeed
+        float rel_vel = vel_x - CalculateWind(altitude, wind_speed, wind_exponent);
+        sample[ch_aoa] = atan2(fabs(rel_vel), fabs(vel));
+    }
+
+    return sample;
+}
+
+void System::AddEvent(FlightEventType type, float time)
+{
+    FlightEvent e{type, time};
+
+    events.push_back(e);
+    summary.OnEvent(e, prev_sample);
+    policy.OnEvent(e, output);
+}
+
+void System::RecordStep()
+{
+    SimSample sample = CaptureSample();
+
+    summary.Update(sample);
+
+    if (p.sim.recordOutput)
+    {
+        dense_output.Advance(prev_sample, sample, output);
+    }
+    prev_sample = sample;
+}
+
+bool System::InCoastRegime()
+{
+    if (coast_q <= 0)
+    {
+        return false;
+    }
 
+    return 0.5f * vars.density * vel * vel < coast_q;
+}
+
+void System::CoastStep()
+{
+    float h = coast_dt;
+    float vel_0 = vel;
+
+    // Do not step past a pending drogue deployment
+    if (past_apogee && !drogue_deployed && recovery.drogue_area > 0)
+    {
+        h = Clamp(apogee_time + recovery.drogue_delay - t, coast_dt, dt);
+    }
+
+    BallisticStep(asl, vel, h);
+    altitude = asl - elevation;
+    downrange += vel_x * h;
+
+    // Mean acceleration over the step, matching the logged velocity interpolant
+    acc = (vel - vel_0) / h;
+    acc_x = 0.0f;
+    mach = vel / 343.0f;
+
+    CalculateDrag();
+
+    t += h;
+}
+
+void System::UpdateRecovery()
+{
+    if (!past_apogee && vel <= 0)
+    {
+        past_apogee = true;
+
+        // Refine to the velocity zero crossing within the last step
+        apogee_time = acc < 0 ? t - vel / acc : t;
+        AddEvent(EVENT_APOGEE, apogee_time);
+    }
+
+    if (!past_apogee)
+    {
+        return;
+    }
+
+    if (!drogue_deployed && recovery.drogue_area > 0 && t >= apogee_time + recovery.drogue_delay)
+    {
+        drogue_deployed = true;
+        AddEvent(EVENT_DROGUE_DEPLOY, t);
+    }
+
+    if (!main_deployed && recovery.main_area > 0 && altitude <= recovery.main_altitude)
+    {
+        main_deployed = true;
+        AddEvent(EVENT_MAIN_DEPLOY, t);
+    }
+}
+
+float System::CalculateCdA()
+{
+    float cda = cd * cs_area;
+
+    // The drogue stays attached after the main opens
+    if (drogue_deployed)
+    {
+        cda += recovery.drogue_cd * recovery.drogue_area;
+    }
+
+    if (main_deployed)
+    {
+        cda += recovery.main_cd * recovery.main_area;
+    }
+
+    return cda;
+}
+
+float System::CalculateTerminalVelocity(float rho, float g)
+{
+    return -sqrt((2 * mass * g) / (rho * CalculateCdA()));
+}
+
+bool System::InDescentEquilibrium()
+{
+    if (descent_drop <= 0 || !past_apogee || vel >= 0)
+    {
+        return false;
+    }
+
+    float v_term = CalculateTerminalVelocity(vars.density, vars.g);
+
+    return fabs(vel - v_term) <= descent_tolerance * fabs(v_term);
+}
+
+bool System::DescentStep()
+{
+    float v_term = CalculateTerminalVelocity(vars.density, vars.g);
+    float h = descent_drop / -v_term;
+    float vel_0 = vel;
+
+    // Terminal velocity and wind at the midpoint account for the change in
+    // density and the wind profile across the step
+    float asl_mid = asl + 0.5f * v_term * h;
+    EnvironmentVars vars_mid = CalculateEnvironmentVariables(asl_mid);
+    float v_mid = CalculateTerminalVelocity(vars_mid.density, vars_mid.g);
+    float wind_mid = CalculateWind(asl_mid - elevation, wind_speed, wind_exponent);
+
+    // The vehicle trails the terminal velocity as it falls into denser air,
+    // by its relaxation time multiplied by the rate of change of v_term
+    float dvdh = (v_mid - v_term) / (asl_mid - asl);
+    float tau = -v_mid / (2 * vars_mid.g);
+    v_mid -= tau * dvdh * v_mid;
+
+    // Finish exactly on the main deployment altitude or the ground
+    bool to_main = !main_deployed && recovery.main_area > 0 && altitude > recovery.main_altitude;
+    float target = to_main ? elevation + recovery.main_altitude : elevation;
+    bool reached = asl + v_mid * h <= target;
+
+    if (reached)
+    {
+        h = (target - asl) / v_mid;
+    }
+
+    // Already on the target to rounding, so act on it rather than take a
+    // zero length step
+    if (h <= 0)
+    {
+        if (to_main)
+        {
+            main_deployed = true;
+            AddEvent(EVENT_MAIN_DEPLOY, t);
+        }
+        else
+        {
+            landed = true;
+        }
+        return false;
+    }
+
+    if (reached)
+    {
+        asl = target;
+        landed = !to_main;
+    }
+    else
+    {
+        asl += v_mid * h;
+    }
+
+    altitude = asl - elevation;
+    vel = v_mid;
+    vel_x = wind_mid;
+    downrange += wind_mid * h;
+
+    acc = (vel - vel_0) / h;
+    acc_x = 0.0f;
+    mach = vel / 343.0f;
+
+    CalculateDrag();
+
+    t += h;
+
+    // Deployed here, as altitude may round to just above the main altitude
+    if (reached && to_main)
+    {
+        main_deployed = true;
+        AddEvent(EVENT_MAIN_DEPLOY, t);
+    }
+
+    return true;
 }
 
 void System::CalculateMass()
@@ -196,7 +634,8 @@ void System::CalculateVelocity()
 
 void System::CalculateAcceleration()
 {
-    acc = (thrust - (mass * vars.g + drag)) / mass;
+    // Drag opposes the direction of travel
+    acc = (thrust * launch_cos - (mass * vars.g + copysign(drag, vel))) / mass;
 }
 
 void System::CalculateThrust()
@@ -209,7 +648,18 @@ void System::CalculateThrust()
 
 void System::CalculateDrag()
 {
-    drag = 0.5 * (vars.density * pow(vel, 2) * cd * cs_area);
+    drag = 0.5 * (vars.density * pow(vel, 2) * CalculateCdA());
+}
+
+void System::CalculateDrift()
+{
+    // Horizontal drag relative to the local wind, scaled by the full airspeed
+    float rel_vel = vel_x - CalculateWind(altitude, wind_speed, wind_exponent);
+    float airspeed = sqrt(pow(rel_vel, 2) + pow(vel, 2));
+
+    acc_x = (thrust * launch_sin - 0.5f * vars.density * airspeed * rel_vel * CalculateCdA()) / mass;
+    downrange += vel_x * dt + (acc_x * pow(dt, 2)) / 2;
+    vel_x += acc_x * dt;
 }
 
 void System::CalculateTWR()
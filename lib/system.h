@@ -23,17 +23,72 @@
 #define SYSTEM_H_
 
 #include <iostream>
+#include <memory>
 #include "types.h"
 #include "environment.h"
 #include "rocket.h"
-#include "../include/matplotlibcpp.h"
+#include "denseoutput.h"
+#include "streamwriter.h"
+#include "flightsummary.h"
+#include "ballistic.h"
 #include "../include/Eigen/Dense"
 
-namespace plt = matplotlibcpp;
+// One of each flight event at most
+const int max_flight_events = EVENT_LANDING + 1;
+
+/*
+* Everything a System needs to resume mid-flight, in fixed-size members so
+* taking one never allocates. The dynamic state, the previous step the
+* output interpolant starts from, the summary so far and the events so far.
+* Configuration comes from the Params of the System it is restored into.
+*/
+struct SystemSnapshot
+{
+    int phase;
+    int burn_step;
+
+    float t;
+    float altitude;
+    float asl;
+    float mass;
+    float propellant_mass;
+    float mass_flow_rate;
+    float avg_thrust;
+    float thrust;
+    float drag;
+    float vel;
+    float mach;
+    float acc;
+
+    float downrange;
+    float vel_x;
+    float acc_x;
+
+    bool past_apogee;
+    float apogee_time;
+    bool drogue_deployed;
+    bool main_deployed;
+    bool landed;
+
+    EnvironmentVars vars;
+    SimSample prev_sample;
+    FlightSummary summary;
+
+    FlightEvent events[max_flight_events];
+    int event_count;
+};
 
 class System
 {
 private:
+    // Stage of an incremental run
+    enum Phase
+    {
+        PHASE_BURN,
+        PHASE_FLIGHT,
+        PHASE_DONE
+    };
+
     Params p;
     EnvironmentVars vars;
 
@@ -58,10 +113,37 @@ private:
     float cd;
     float cs_area;
 
+    // Recovery
+    RecoveryParameters recovery;
+    bool past_apogee;
+    float apogee_time;
+    bool drogue_deployed;
+    bool main_deployed;
+    bool landed;
+
+    // Wind and horizontal drift
+    float wind_speed;
+    float wind_exponent;
+    float downrange;
+    float vel_x;
+    float acc_x;
+
+    // Thrust direction off the rail, held through the burn
+    float launch_cos;
+    float launch_sin;
+
     float elevation;
     float dt;
     float num_steps;
 
+    // Ballistic coast regime
+    float coast_q;
+    float coast_dt;
+
+    // Quasi-steady descent regime
+    float descent_drop;
+    float descent_tolerance;
+
     float t;
     float altitude;
     float asl;
@@ -73,6 +155,26 @@ private:
     float mach;
     float acc;
 
+    // Output sampling
+    DenseOutput dense_output;
+    RecordingPolicy policy;
+    int ch_aoa;
+    SimSample prev_sample;
+
+    SimSample CaptureSample();
+    void RecordStep();
+    void AddEvent(FlightEventType type, float time);
+
+    bool InCoastRegime();
+    void CoastStep();
+
+    void UpdateRecovery();
+    float CalculateCdA();
+    float CalculateTerminalVelocity(float rho, float g);
+    bool InDescentEquilibrium();
+    // False when it only deployed or landed, without advancing t
+    bool DescentStep();
+
     void CalculateMass();
     void CalculatePropellant();
     void CalculateAltitude();
@@ -81,16 +183,51 @@ private:
     void CalculateThrust();
     void CalculateDrag();
     void CalculateTWR();
+    void CalculateDrift();
+
+    Phase phase;
+    int burn_step;
+
+    // Shared so System stays copyable, only set while streaming
+    std::shared_ptr<StreamWriter> stream;
+
+    void Open();
+    void BurnStep();
+    void FlightStep();
+    void Finish();
 
 public:
-    SimOutput output;
+    TrajectoryRecorder output;
+    std::vector<FlightEvent> events;
+    FlightSummary summary;
 
     System();
 
     System(Params _params);
 
+    const Params &Parameters() const;
+
+    void SetOutputTimes(std::vector<float> times);
+
     void RunSimulation();
 
+    /*
+    * Incremental run, the same as RunSimulation. Step advances one
+    * integration step and returns false once the vehicle has landed, so a
+    * run can be paused between steps and resumed on another thread.
+    */
+    void Begin();
+    bool Step();
+    bool Done() const;
+
+    /*
+    * Restore continues a run from a snapshot of another System, with this
+    * System's parameters acting from the snapshot time on. Output is
+    * recorded from the snapshot time, events and summary carry over.
+    */
+    SystemSnapshot Snapshot() const;
+    void Restore(const SystemSnapshot &snapshot);
+
     void UpdateEnvironment();
 
     ~System();
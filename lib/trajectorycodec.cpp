@@ -0,0 +1,314 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "trajectorycodec.h"
+#include <string.h>
+
+static uint32_t FloatBits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+static float BitsFloat(uint32_t bits)
+{
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Two's complement value of the low n bits
+static int64_t SignExtend(uint64_t value, int n)
+{
+    return (int64_t)(value << (64 - n)) >> (64 - n);
+}
+
+BitWriter::BitWriter(std::vector<uint8_t> &_out)
+    : out(_out)
+{
+    bits = 0;
+    count = 0;
+}
+
+void BitWriter::Write(uint32_t value, int n)
+{
+    if (n == 0)
+    {
+        return;
+    }
+
+    uint64_t mask = n == 32 ? 0xffffffffull : ((1ull << n) - 1);
+
+    bits = (bits << n) | (value & mask);
+    count += n;
+
+    while (count >= 8)
+    {
+        count -= 8;
+        out.push_back((uint8_t)(bits >> count));
+    }
+}
+
+void BitWriter::Finish()
+{
+    if (count > 0)
+    {
+        out.push_back((uint8_t)(bits << (8 - count)));
+    }
+
+    bits = 0;
+    count = 0;
+}
+
+BitReader::BitReader(const uint8_t *_data, size_t _length)
+{
+    data = _data;
+    length = _length;
+    position = 0;
+}
+
+uint32_t BitReader::Read(int n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    size_t byte = position >> 3;
+    uint64_t word = 0;
+
+    // Eight bytes cover any 32 bit read at any bit offset, loaded big
+    // endian on the little endian hosts the file format assumes
+    if (byte + 8 <= length)
+    {
+        memcpy(&word, data + byte, 8);
+        word = __builtin_bswap64(word);
+    }
+    else
+    {
+        for (size_t i = 0; i < 8; i++)
+        {
+            word = (word << 8) | (byte + i < length ? data[byte + i] : 0);
+        }
+    }
+
+    uint32_t value = (uint32_t)((word << (position & 7)) >> (64 - n));
+    position += n;
+
+    return value;
+}
+
+void EncodeDeltaBlock(const float *values, size_t n, std::vector<uint8_t> &out)
+{
+    BitWriter writer(out);
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    int64_t prev = FloatBits(values[0]);
+    int64_t prev_delta = 0;
+    writer.Write((uint32_t)prev, 32);
+
+    for (size_t i = 1; i < n; i++)
+    {
+        int64_t curr = FloatBits(values[i]);
+        int64_t delta = curr - prev;
+        int64_t dod = delta - prev_delta;
+
+        if (dod == 0)
+        {
+            writer.Write(0, 1);
+        }
+        else if (dod >= -64 && dod < 64)
+        {
+            writer.Write(0x2, 2);
+            writer.Write((uint32_t)dod, 7);
+        }
+        else if (dod >= -256 && dod < 256)
+        {
+            writer.Write(0x6, 3);
+            writer.Write((uint32_t)dod, 9);
+        }
+        else if (dod >= -2048 && dod < 2048)
+        {
+            writer.Write(0xe, 4);
+            writer.Write((uint32_t)dod, 12);
+        }
+        else
+        {
+            // Differences of 32 bit patterns need up to 34 bits
+            writer.Write(0xf, 4);
+            writer.Write((uint32_t)((uint64_t)dod >> 32), 32);
+            writer.Write((uint32_t)dod, 32);
+        }
+
+        prev = curr;
+        prev_delta = delta;
+    }
+
+    writer.Finish();
+}
+
+void DecodeDeltaBlock(const uint8_t *data, size_t length, size_t n, float *values)
+{
+    BitReader reader(data, length);
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    int64_t prev = reader.Read(32);
+    int64_t prev_delta = 0;
+    values[0] = BitsFloat((uint32_t)prev);
+
+    for (size_t i = 1; i < n; i++)
+    {
+        int64_t dod;
+
+        if (reader.Read(1) == 0)
+        {
+            dod = 0;
+        }
+        else if (reader.Read(1) == 0)
+        {
+            dod = SignExtend(reader.Read(7), 7);
+        }
+        else if (reader.Read(1) == 0)
+        {
+            dod = SignExtend(reader.Read(9), 9);
+        }
+        else if (reader.Read(1) == 0)
+        {
+            dod = SignExtend(reader.Read(12), 12);
+        }
+        else
+        {
+            uint64_t high = reader.Read(32);
+            dod = (int64_t)((high << 32) | reader.Read(32));
+        }
+
+        prev_delta += dod;
+        prev += prev_delta;
+        values[i] = BitsFloat((uint32_t)prev);
+    }
+}
+
+void EncodeXorBlock(const float *values, size_t n, std::vector<uint8_t> &out)
+{
+    BitWriter writer(out);
+
+    if (n == 0)
+    {
+        return;
+    }
+
+    uint32_t prev = FloatBits(values[0]);
+    writer.Write(prev, 32);
+
+    // Meaningful bit window of the last value written in full
+    int lead = -1;
+    int trail = 0;
+
+    for (size_t i = 1; i < n; i++)
+    {
+        uint32_t curr = FloatBits(values[i]);
+        uint32_t x = curr ^ prev;
+
+        if (x == 0)
+        {
+            writer.Write(0, 1);
+        }
+        else
+        {
+            int l = __builtin_clz(x);
+            int t = __builtin_ctz(x);
+
+            if (lead >= 0 && l >= lead && t >= trail)
+            {
+                // Fits the previous window
+                writer.Write(0x2, 2);
+                writer.Write(x >> trail, 32 - lead - trail);
+            }
+            else
+            {
+                lead = l;
+                trail = t;
+
+                writer.Write(0x3, 2);
+                writer.Write(lead, 5);
+                writer.Write(31 - lead - trail, 5);
+                writer.Write(x >> trail, 32 - lead - trail);
+            }
+        }
+
+        prev = curr;
+    }
+
+    writer.Finish();
+}
+
+bool DecodeXorBlock(const uint8_t *data, size_t length, size_t n, float *values)
+{
+    BitReader reader(data, length);
+
+    if (n == 0)
+    {
+        return true;
+    }
+
+    uint32_t prev = reader.Read(32);
+    values[0] = BitsFloat(prev);
+
+    int lead = 0;
+    int trail = 0;
+
+    for (size_t i = 1; i < n; i++)
+    {
+        if (reader.Read(1) == 1)
+        {
+            if (reader.Read(1) == 1)
+            {
+                lead = reader.Read(5);
+                int meaningful = reader.Read(5);
+
+                // The window must fit in the 32 bits of a float
+                if (lead + meaningful > 31)
+                {
+                    return false;
+                }
+
+                trail = 31 - lead - meaningful;
+            }
+
+            prev ^= reader.Read(32 - lead - trail) << trail;
+        }
+
+        values[i] = BitsFloat(prev);
+    }
+
+    return true;
+}
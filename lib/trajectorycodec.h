@@ -0,0 +1,80 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef TRAJECTORYCODEC_H_
+#define TRAJECTORYCODEC_H_
+
+#include <vector>
+#include <stdint.h>
+#include <stddef.h>
+
+// Appends bits most significant first to a byte buffer
+class BitWriter
+{
+private:
+    std::vector<uint8_t> &out;
+    uint64_t bits;
+    int count;
+
+public:
+    BitWriter(std::vector<uint8_t> &_out);
+
+    // Up to 32 bits at a time
+    void Write(uint32_t value, int n);
+    // Pad the final byte with zeros
+    void Finish();
+};
+
+class BitReader
+{
+private:
+    const uint8_t *data;
+    size_t length;
+    size_t position;
+
+public:
+    BitReader(const uint8_t *_data, size_t _length);
+
+    // Up to 32 bits at a time, zeros past the end of the data
+    uint32_t Read(int n);
+};
+
+/*
+* Block codecs for float columns. Each block is encoded on its own, starting
+* from a raw first value, so any block can be decoded without the ones
+* before it.
+*
+* Delta suits monotonic series such as time: the second difference of the
+* float bit patterns is written with a variable length prefix code, one bit
+* when the spacing is unchanged. XOR follows Gorilla: each value is XORed
+* with the previous one and only the meaningful bits are written, one bit
+* when the value repeats. An XOR block whose bit window runs past 32 bits
+* is corrupt and decodes to false.
+*/
+void EncodeDeltaBlock(const float *values, size_t n, std::vector<uint8_t> &out);
+void DecodeDeltaBlock(const uint8_t *data, size_t length, size_t n, float *values);
+
+void EncodeXorBlock(const float *values, size_t n, std::vector<uint8_t> &out);
+bool DecodeXorBlock(const uint8_t *data, size_t length, size_t n, float *values);
+
+#endif
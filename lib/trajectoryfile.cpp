@@ -0,0 +1,551 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "trajectoryfile.h"
+#include "trajectorycodec.h"
+#include <iostream>
+#include <fstream>
+#include <string.h>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static uint64_t AlignUp(uint64_t offset)
+{
+    return (offset + trajectory_column_alignment - 1) / trajectory_column_alignment * trajectory_column_alignment;
+}
+
+static void CopyField(char *field, size_t length, const std::string &value)
+{
+    memset(field, 0, length);
+    memcpy(field, value.c_str(), std::min(value.size(), length - 1));
+}
+
+static std::string ReadField(const char *field, size_t length)
+{
+    return std::string(field, strnlen(field, length));
+}
+
+// Mapped columns are handed out in place, so the host must share the file byte order
+static bool HostLittleEndian(const std::string &filename)
+{
+    const uint32_t one = 1;
+    uint8_t first;
+    memcpy(&first, &one, 1);
+
+    if (first != 1)
+    {
+        std::cout << "Error: Trajectory file " << filename << " needs a little endian host" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// Map a whole file read-only, null on failure
+static const uint8_t *MapFile(const std::string &filename, size_t min_length, size_t &length)
+{
+    if (!HostLittleEndian(filename))
+    {
+        return nullptr;
+    }
+
+    int fd = open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        std::cout << "Error: Cannot open trajectory file " << filename << std::endl;
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < min_length)
+    {
+        std::cout << "Error: " << filename << " is not a trajectory file" << std::endl;
+        close(fd);
+        return nullptr;
+    }
+
+    void *map = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+    {
+        std::cout << "Error: Cannot map trajectory file " << filename << std::endl;
+        return nullptr;
+    }
+
+    length = st.st_size;
+
+    return (const uint8_t *)map;
+}
+
+bool WriteTrajectoryFile(const TrajectoryRecorder &output, const std::string &filename)
+{
+    if (!HostLittleEndian(filename))
+    {
+        return false;
+    }
+
+    const std::vector<int> &channels = output.ChannelList();
+    uint64_t num_samples = output.Size();
+
+    TrajectoryFileHeader header;
+    memcpy(header.magic, trajectory_file_magic, sizeof(header.magic));
+    header.version = trajectory_file_version;
+    header.num_columns = (uint32_t)channels.size();
+    header.num_samples = num_samples;
+    header.data_offset = AlignUp(sizeof(TrajectoryFileHeader) + channels.size() * sizeof(TrajectoryColumnSchema));
+
+    std::vector<TrajectoryColumnSchema> schema(channels.size());
+    uint64_t offset = header.data_offset;
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        ChannelInfo info = GetChannelInfo(channels[c]);
+
+        CopyField(schema[c].name, trajectory_name_length, info.name);
+        CopyField(schema[c].unit, trajectory_unit_length, info.unit);
+        schema[c].type = COLUMN_FLOAT32;
+        schema[c].reserved = 0;
+        schema[c].offset = offset;
+
+        offset = AlignUp(offset + num_samples * sizeof(float));
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "Error: Cannot open trajectory file " << filename << std::endl;
+        return false;
+    }
+
+    const char padding[trajectory_column_alignment] = {};
+    uint64_t position = 0;
+
+    file.write((const char *)&header, sizeof(header));
+    file.write((const char *)schema.data(), schema.size() * sizeof(TrajectoryColumnSchema));
+    position = sizeof(header) + schema.size() * sizeof(TrajectoryColumnSchema);
+
+    // Columns go out one chunk at a time, each chunk already contiguous
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        file.write(padding, schema[c].offset - position);
+        position = schema[c].offset;
+
+        ColumnView column = output.Column(channels[c]);
+        for (size_t k = 0; k < column.NumChunks(); k++)
+        {
+            file.write((const char *)column.ChunkData(k), column.ChunkLength(k) * sizeof(float));
+        }
+        position += num_samples * sizeof(float);
+    }
+    file.write(padding, offset - position);
+
+    if (!file)
+    {
+        std::cout << "Error: Failed writing trajectory file " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool WriteCompressedTrajectoryFile(const TrajectoryRecorder &output, const std::string &filename, size_t block_size)
+{
+    if (!HostLittleEndian(filename))
+    {
+        return false;
+    }
+
+    const std::vector<int> &channels = output.ChannelList();
+    uint64_t num_samples = output.Size();
+    size_t num_blocks = (num_samples + block_size - 1) / block_size;
+
+    CompressedTrajectoryHeader header;
+    memcpy(header.magic, compressed_trajectory_magic, sizeof(header.magic));
+    header.version = trajectory_file_version;
+    header.num_columns = (uint32_t)channels.size();
+    header.num_samples = num_samples;
+    header.block_size = (uint32_t)block_size;
+    header.reserved = 0;
+
+    std::vector<TrajectoryColumnSchema> schema(channels.size());
+    std::vector<std::vector<uint64_t>> index(channels.size());
+    std::vector<std::vector<uint8_t>> encoded(channels.size());
+    std::vector<float> block(block_size);
+
+    uint64_t offset = sizeof(header) + channels.size() * sizeof(TrajectoryColumnSchema);
+
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        ChannelInfo info = GetChannelInfo(channels[c]);
+        ColumnView column = output.Column(channels[c]);
+
+        CopyField(schema[c].name, trajectory_name_length, info.name);
+        CopyField(schema[c].unit, trajectory_unit_length, info.unit);
+        schema[c].type = channels[c] == CH_T ? COLUMN_FLOAT32_DELTA : COLUMN_FLOAT32_XOR;
+        schema[c].reserved = 0;
+        schema[c].offset = offset;
+
+        // Block offsets are relative to the column data until it is placed
+        for (size_t b = 0; b < num_blocks; b++)
+        {
+            size_t start = b * block_size;
+            size_t n = std::min<size_t>(block_size, num_samples - start);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                block[i] = column[start + i];
+            }
+
+            index[c].push_back(encoded[c].size());
+
+            if (schema[c].type == COLUMN_FLOAT32_DELTA)
+            {
+                EncodeDeltaBlock(block.data(), n, encoded[c]);
+            }
+            else
+            {
+                EncodeXorBlock(block.data(), n, encoded[c]);
+            }
+        }
+        index[c].push_back(encoded[c].size());
+
+        uint64_t data_offset = offset + index[c].size() * sizeof(uint64_t);
+        for (size_t b = 0; b < index[c].size(); b++)
+        {
+            index[c][b] += data_offset;
+        }
+
+        // Keep each block index 8 byte aligned
+        offset = (data_offset + encoded[c].size() + 7) / 8 * 8;
+    }
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file)
+    {
+        std::cout << "Error: Cannot open trajectory file " << filename << std::endl;
+        return false;
+    }
+
+    const char padding[8] = {};
+
+    file.write((const char *)&header, sizeof(header));
+    file.write((const char *)schema.data(), schema.size() * sizeof(TrajectoryColumnSchema));
+
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        file.write((const char *)index[c].data(), index[c].size() * sizeof(uint64_t));
+        file.write((const char *)encoded[c].data(), encoded[c].size());
+        file.write(padding, (8 - encoded[c].size() % 8) % 8);
+    }
+
+    if (!file)
+    {
+        std::cout << "Error: Failed writing trajectory file " << filename << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool IsCompressedTrajectoryFile(const std::string &filename)
+{
+    char magic[8] = {};
+
+    std::ifstream file(filename, std::ios::binary);
+    file.read(magic, sizeof(magic));
+
+    return file && memcmp(magic, compressed_trajectory_magic, sizeof(magic)) == 0;
+}
+
+TrajectoryFile::TrajectoryFile()
+{
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    schema = nullptr;
+}
+
+bool TrajectoryFile::Open(const std::string &filename)
+{
+    Close();
+
+    data = MapFile(filename, sizeof(TrajectoryFileHeader), length);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    header = (const TrajectoryFileHeader *)data;
+    schema = (const TrajectoryColumnSchema *)(data + sizeof(TrajectoryFileHeader));
+
+    // Validate the header and every column extent before handing out pointers
+    bool valid = memcmp(header->magic, trajectory_file_magic, sizeof(header->magic)) == 0 &&
+                 header->version == trajectory_file_version &&
+                 sizeof(TrajectoryFileHeader) + header->num_columns * sizeof(TrajectoryColumnSchema) <= length;
+
+    // Extents are compared as counts within the file, so a corrupt offset or
+    // sample count cannot wrap around the sum
+    for (size_t c = 0; valid && c < header->num_columns; c++)
+    {
+        valid = schema[c].type == COLUMN_FLOAT32 &&
+                schema[c].offset % sizeof(float) == 0 &&
+                schema[c].offset <= length &&
+                header->num_samples <= (length - schema[c].offset) / sizeof(float);
+    }
+
+    if (!valid)
+    {
+        std::cout << "Error: " << filename << " is not a valid trajectory file" << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void TrajectoryFile::Close()
+{
+    if (data != nullptr)
+    {
+        munmap((void *)data, length);
+    }
+
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    schema = nullptr;
+}
+
+bool TrajectoryFile::IsOpen() const
+{
+    return data != nullptr;
+}
+
+size_t TrajectoryFile::NumColumns() const
+{
+    return header == nullptr ? 0 : header->num_columns;
+}
+
+size_t TrajectoryFile::NumSamples() const
+{
+    return header == nullptr ? 0 : header->num_samples;
+}
+
+std::string TrajectoryFile::ColumnName(size_t c) const
+{
+    return ReadField(schema[c].name, trajectory_name_length);
+}
+
+std::string TrajectoryFile::ColumnUnit(size_t c) const
+{
+    return ReadField(schema[c].unit, trajectory_unit_length);
+}
+
+int TrajectoryFile::FindColumn(const std::string &name) const
+{
+    for (size_t c = 0; c < NumColumns(); c++)
+    {
+        if (ColumnName(c) == name)
+        {
+            return (int)c;
+        }
+    }
+
+    return -1;
+}
+
+const float *TrajectoryFile::Column(size_t c) const
+{
+    return (const float *)(data + schema[c].offset);
+}
+
+TrajectoryFile::~TrajectoryFile()
+{
+    Close();
+}
+
+CompressedTrajectoryFile::CompressedTrajectoryFile()
+{
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    schema = nullptr;
+}
+
+bool CompressedTrajectoryFile::Open(const std::string &filename)
+{
+    Close();
+
+    data = MapFile(filename, sizeof(CompressedTrajectoryHeader), length);
+    if (data == nullptr)
+    {
+        return false;
+    }
+
+    header = (const CompressedTrajectoryHeader *)data;
+    schema = (const TrajectoryColumnSchema *)(data + sizeof(CompressedTrajectoryHeader));
+
+    // Validate the header and every block index before decoding anything
+    bool valid = memcmp(header->magic, compressed_trajectory_magic, sizeof(header->magic)) == 0 &&
+                 header->version == trajectory_file_version &&
+                 header->block_size > 0 &&
+                 sizeof(CompressedTrajectoryHeader) + header->num_columns * sizeof(TrajectoryColumnSchema) <= length;
+
+    // Extents are compared as counts within the file, so a corrupt offset or
+    // sample count cannot wrap around the sum
+    for (size_t c = 0; valid && c < header->num_columns; c++)
+    {
+        valid = (schema[c].type == COLUMN_FLOAT32_DELTA || schema[c].type == COLUMN_FLOAT32_XOR) &&
+                schema[c].offset % sizeof(uint64_t) == 0 &&
+                schema[c].offset <= length &&
+                NumBlocks() < (length - schema[c].offset) / sizeof(uint64_t);
+
+        const uint64_t *index = BlockIndex(c);
+        for (size_t b = 0; valid && b < NumBlocks(); b++)
+        {
+            valid = index[b] <= index[b + 1] && index[b + 1] <= length;
+        }
+    }
+
+    if (!valid)
+    {
+        std::cout << "Error: " << filename << " is not a valid trajectory file" << std::endl;
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void CompressedTrajectoryFile::Close()
+{
+    if (data != nullptr)
+    {
+        munmap((void *)data, length);
+    }
+
+    data = nullptr;
+    length = 0;
+    header = nullptr;
+    schema = nullptr;
+}
+
+bool CompressedTrajectoryFile::IsOpen() const
+{
+    return data != nullptr;
+}
+
+size_t CompressedTrajectoryFile::NumColumns() const
+{
+    return header == nullptr ? 0 : header->num_columns;
+}
+
+size_t CompressedTrajectoryFile::NumSamples() const
+{
+    return header == nullptr ? 0 : header->num_samples;
+}
+
+size_t CompressedTrajectoryFile::BlockSize() const
+{
+    return header == nullptr ? 0 : header->block_size;
+}
+
+size_t CompressedTrajectoryFile::NumBlocks() const
+{
+    if (header == nullptr)
+    {
+        return 0;
+    }
+
+    // Rounded up without overflowing on a corrupt sample count
+    return header->num_samples / header->block_size + (header->num_samples % header->block_size != 0);
+}
+
+size_t CompressedTrajectoryFile::BlockLength(size_t b) const
+{
+    return std::min<size_t>(BlockSize(), NumSamples() - b * BlockSize());
+}
+
+std::string CompressedTrajectoryFile::ColumnName(size_t c) const
+{
+    return ReadField(schema[c].name, trajectory_name_length);
+}
+
+std::string CompressedTrajectoryFile::ColumnUnit(size_t c) const
+{
+    return ReadField(schema[c].unit, trajectory_unit_length);
+}
+
+int CompressedTrajectoryFile::FindColumn(const std::string &name) const
+{
+    for (size_t c = 0; c < NumColumns(); c++)
+    {
+        if (ColumnName(c) == name)
+        {
+            return (int)c;
+        }
+    }
+
+    return -1;
+}
+
+const uint64_t *CompressedTrajectoryFile::BlockIndex(size_t c) const
+{
+    return (const uint64_t *)(data + schema[c].offset);
+}
+
+bool CompressedTrajectoryFile::DecodeBlock(size_t c, size_t b, float *values) const
+{
+    const uint64_t *index = BlockIndex(c);
+
+    if (schema[c].type == COLUMN_FLOAT32_DELTA)
+    {
+        DecodeDeltaBlock(data + index[b], index[b + 1] - index[b], BlockLength(b), values);
+        return true;
+    }
+
+    return DecodeXorBlock(data + index[b], index[b + 1] - index[b], BlockLength(b), values);
+}
+
+std::vector<float> CompressedTrajectoryFile::DecodeColumn(size_t c) const
+{
+    std::vector<float> values(NumSamples());
+
+    for (size_t b = 0; b < NumBlocks(); b++)
+    {
+        if (!DecodeBlock(c, b, values.data() + b * BlockSize()))
+        {
+            return std::vector<float>();
+        }
+    }
+
+    return values;
+}
+
+CompressedTrajectoryFile::~CompressedTrajectoryFile()
+{
+    Close();
+}
@@ -0,0 +1,181 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef TRAJECTORYFILE_H_
+#define TRAJECTORYFILE_H_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "recorder.h"
+
+/*
+* Binary columnar trajectory file. A fixed header is followed by one schema
+* entry per column and then the column data, each column contiguous and
+* aligned so a mapped file can be read in place. Values are little endian,
+* and as they are read in place rather than swapped, files are only written
+* and opened on little endian hosts.
+*
+*   header   magic, version, column count, sample count, header size
+*   schema   name, unit, type and byte offset of each column
+*   data     column 0 samples, column 1 samples, ...
+*/
+enum TrajectoryColumnType
+{
+    COLUMN_FLOAT32,
+    COLUMN_FLOAT32_DELTA,
+    COLUMN_FLOAT32_XOR
+};
+
+const char trajectory_file_magic[8] = {'R', 'S', 'I', 'M', 'T', 'R', 'J', 0};
+const uint32_t trajectory_file_version = 1;
+const size_t trajectory_name_length = 32;
+const size_t trajectory_unit_length = 16;
+const size_t trajectory_column_alignment = 64;
+
+const char compressed_trajectory_magic[8] = {'R', 'S', 'I', 'M', 'T', 'R', 'Z', 0};
+const size_t compressed_block_size = 1024;
+
+struct TrajectoryFileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_columns;
+    uint64_t num_samples;
+    uint64_t data_offset;
+};
+
+struct TrajectoryColumnSchema
+{
+    char name[trajectory_name_length];
+    char unit[trajectory_unit_length];
+    uint32_t type;
+    uint32_t reserved;
+    uint64_t offset;
+};
+
+/*
+* The compressed variant splits each column into blocks of block_size
+* samples, encoded independently (see trajectorycodec.h). A column's schema
+* offset points at its block index, num_blocks + 1 file offsets where the
+* last marks the end of the final block.
+*/
+struct CompressedTrajectoryHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t num_columns;
+    uint64_t num_samples;
+    uint32_t block_size;
+    uint32_t reserved;
+};
+
+// Write every subscribed channel of a recording, returns false on failure
+bool WriteTrajectoryFile(const TrajectoryRecorder &output, const std::string &filename);
+bool WriteCompressedTrajectoryFile(const TrajectoryRecorder &output, const std::string &filename,
+                                   size_t block_size = compressed_block_size);
+
+bool IsCompressedTrajectoryFile(const std::string &filename);
+
+/*
+* Read-only memory mapped trajectory file. Columns point straight into the
+* mapping, so they stay valid until the file is closed.
+*/
+class TrajectoryFile
+{
+private:
+    const uint8_t *data;
+    size_t length;
+
+    const TrajectoryFileHeader *header;
+    const TrajectoryColumnSchema *schema;
+
+    TrajectoryFile(const TrajectoryFile &);
+    TrajectoryFile &operator=(const TrajectoryFile &);
+
+public:
+    TrajectoryFile();
+
+    bool Open(const std::string &filename);
+    void Close();
+    bool IsOpen() const;
+
+    size_t NumColumns() const;
+    size_t NumSamples() const;
+
+    std::string ColumnName(size_t c) const;
+    std::string ColumnUnit(size_t c) const;
+    // Column index by name, -1 if there is none
+    int FindColumn(const std::string &name) const;
+
+    const float *Column(size_t c) const;
+
+    ~TrajectoryFile();
+};
+
+/*
+* Read-only memory mapped compressed trajectory file. Blocks are decoded on
+* request, so reading part of a column only touches the blocks covering it.
+*/
+class CompressedTrajectoryFile
+{
+private:
+    const uint8_t *data;
+    size_t length;
+
+    const CompressedTrajectoryHeader *header;
+    const TrajectoryColumnSchema *schema;
+
+    CompressedTrajectoryFile(const CompressedTrajectoryFile &);
+    CompressedTrajectoryFile &operator=(const CompressedTrajectoryFile &);
+
+    const uint64_t *BlockIndex(size_t c) const;
+
+public:
+    CompressedTrajectoryFile();
+
+    bool Open(const std::string &filename);
+    void Close();
+    bool IsOpen() const;
+
+    size_t NumColumns() const;
+    size_t NumSamples() const;
+    size_t BlockSize() const;
+    size_t NumBlocks() const;
+    // Samples in a block, short for the final one
+    size_t BlockLength(size_t b) const;
+
+    std::string ColumnName(size_t c) const;
+    std::string ColumnUnit(size_t c) const;
+    // Column index by name, -1 if there is none
+    int FindColumn(const std::string &name) const;
+
+    // Decode one block of a column into BlockLength(b) values, false if corrupt
+    bool DecodeBlock(size_t c, size_t b, float *values) const;
+    // Empty if any block is corrupt
+    std::vector<float> DecodeColumn(size_t c) const;
+
+    ~CompressedTrajectoryFile();
+};
+
+#endif
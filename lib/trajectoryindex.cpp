@@ -0,0 +1,264 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "trajectoryindex.h"
+#include <math.h>
+#include <algorithm>
+
+TrajectoryIndex::TrajectoryIndex(const TrajectoryRecorder &_output)
+    : output(&_output), time(_output.Column(CH_T)), tables(max_channels)
+{
+}
+
+size_t TrajectoryIndex::Size() const
+{
+    return time.Size();
+}
+
+const TrajectoryIndex::SparseTable &TrajectoryIndex::Table(int ch) const
+{
+    SparseTable &table = tables[ch];
+
+    if (table.max.empty() && Size() > 0)
+    {
+        table.max.push_back(output->Column(ch).ToVector());
+        table.min.push_back(table.max[0]);
+
+        for (size_t k = 1; ((size_t)1 << k) <= Size(); k++)
+        {
+            const std::vector<float> &max_prev = table.max[k - 1];
+            const std::vector<float> &min_prev = table.min[k - 1];
+            size_t half = (size_t)1 << (k - 1);
+            size_t n = Size() - ((size_t)1 << k) + 1;
+
+            std::vector<float> max_level(n);
+            std::vector<float> min_level(n);
+
+            for (size_t i = 0; i < n; i++)
+            {
+                max_level[i] = std::max(max_prev[i], max_prev[i + half]);
+                min_level[i] = std::min(min_prev[i], min_prev[i + half]);
+            }
+
+            table.max.push_back(max_level);
+            table.min.push_back(min_level);
+        }
+    }
+
+    return table;
+}
+
+// Largest k with 2^k no more than n
+static size_t Log2(size_t n)
+{
+    size_t k = 0;
+
+    while (((size_t)2 << k) <= n)
+    {
+        k++;
+    }
+
+    return k;
+}
+
+float TrajectoryIndex::RangeMax(const SparseTable &table, size_t first, size_t last) const
+{
+    size_t k = Log2(last - first + 1);
+
+    return std::max(table.max[k][first], table.max[k][last + 1 - ((size_t)1 << k)]);
+}
+
+float TrajectoryIndex::RangeMin(const SparseTable &table, size_t first, size_t last) const
+{
+    size_t k = Log2(last - first + 1);
+
+    return std::min(table.min[k][first], table.min[k][last + 1 - ((size_t)1 << k)]);
+}
+
+size_t TrajectoryIndex::FirstAtOrAbove(const SparseTable &table, size_t start, float threshold) const
+{
+    // Skip the largest runs that stay below, halving the run each time
+    size_t i = start;
+
+    for (size_t k = table.max.size(); k-- > 0;)
+    {
+        if (i + ((size_t)1 << k) <= Size() && table.max[k][i] < threshold)
+        {
+            i += (size_t)1 << k;
+        }
+    }
+
+    return i;
+}
+
+size_t TrajectoryIndex::FirstBelow(const SparseTable &table, size_t start, float threshold) const
+{
+    size_t i = start;
+
+    for (size_t k = table.min.size(); k-- > 0;)
+    {
+        if (i + ((size_t)1 << k) <= Size() && table.min[k][i] >= threshold)
+        {
+            i += (size_t)1 << k;
+        }
+    }
+
+    return i;
+}
+
+size_t TrajectoryIndex::Find(float t) const
+{
+    // Upper bound on the time channel, less one
+    size_t lo = 0;
+    size_t hi = Size();
+
+    while (lo < hi)
+    {
+        size_t mid = (lo + hi) / 2;
+
+        if (time[mid] <= t)
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+
+    return lo > 0 ? lo - 1 : 0;
+}
+
+float TrajectoryIndex::At(int ch, float t) const
+{
+    ColumnView column = output->Column(ch);
+
+    if (Size() == 0 || column.Size() == 0)
+    {
+        return 0.0f;
+    }
+
+    size_t i = Find(t);
+
+    if (t <= time[i] || i + 1 >= Size())
+    {
+        return column[i];
+    }
+
+    return Interpolate(time[i], time[i + 1], column[i], column[i + 1], t);
+}
+
+SimSample TrajectoryIndex::StateAt(float t) const
+{
+    SimSample s;
+    const std::vector<int> &channels = output->ChannelList();
+
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        s[channels[c]] = At(channels[c], t);
+    }
+
+    return s;
+}
+
+float TrajectoryIndex::CrossingTime(int ch, size_t i, float threshold) const
+{
+    ColumnView column = output->Column(ch);
+
+    if (i == 0 || column[i] == column[i - 1])
+    {
+        return time[i];
+    }
+
+    return Interpolate(column[i - 1], column[i], time[i - 1], time[i], threshold);
+}
+
+float TrajectoryIndex::FirstCrossing(int ch, float threshold, bool rising, float t_start) const
+{
+    if (Size() == 0 || output->Column(ch).Size() == 0)
+    {
+        return NAN;
+    }
+
+    const SparseTable &table = Table(ch);
+    size_t start = Find(t_start);
+
+    // A rising crossing needs a sample below first, a falling one a sample
+    // at or above
+    size_t from = rising ? FirstBelow(table, start, threshold) : FirstAtOrAbove(table, start, threshold);
+    if (from >= Size())
+    {
+        return NAN;
+    }
+
+    size_t i = rising ? FirstAtOrAbove(table, from, threshold) : FirstBelow(table, from, threshold);
+    if (i >= Size())
+    {
+        return NAN;
+    }
+
+    return CrossingTime(ch, i, threshold);
+}
+
+float TrajectoryIndex::Max(int ch, float t0, float t1) const
+{
+    if (Size() == 0 || output->Column(ch).Size() == 0)
+    {
+        return NAN;
+    }
+
+    // Interpolated ends, plus the samples inside the window
+    float value = std::max(At(ch, t0), At(ch, t1));
+    size_t first = Find(t0) + 1;
+    size_t last = Find(t1);
+
+    if (first <= last)
+    {
+        value = std::max(value, RangeMax(Table(ch), first, last));
+    }
+
+    return value;
+}
+
+float TrajectoryIndex::Min(int ch, float t0, float t1) const
+{
+    if (Size() == 0 || output->Column(ch).Size() == 0)
+    {
+        return NAN;
+    }
+
+    float value = std::min(At(ch, t0), At(ch, t1));
+    size_t first = Find(t0) + 1;
+    size_t last = Find(t1);
+
+    if (first <= last)
+    {
+        value = std::min(value, RangeMin(Table(ch), first, last));
+    }
+
+    return value;
+}
+
+TrajectoryIndex::~TrajectoryIndex()
+{
+}
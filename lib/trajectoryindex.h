@@ -0,0 +1,91 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef TRAJECTORYINDEX_H_
+#define TRAJECTORYINDEX_H_
+
+#include <vector>
+#include "types.h"
+#include "recorder.h"
+
+/*
+* Time-indexed queries over a recorded trajectory. Lookups binary search the
+* time channel and interpolate linearly between samples. Range and crossing
+* queries use a min/max sparse table per channel, built the first time the
+* channel is queried, so each answers in O(log n).
+*
+* The index refers to the recorder rather than copying it, so it must not
+* outlive the recording, and is not safe to share between threads.
+*/
+class TrajectoryIndex
+{
+private:
+    // Level k holds the extreme of each run of 2^k samples
+    struct SparseTable
+    {
+        std::vector<std::vector<float>> max;
+        std::vector<std::vector<float>> min;
+    };
+
+    const TrajectoryRecorder *output;
+    ColumnView time;
+
+    mutable std::vector<SparseTable> tables;
+
+    const SparseTable &Table(int ch) const;
+
+    // Extremes over samples first to last inclusive
+    float RangeMax(const SparseTable &table, size_t first, size_t last) const;
+    float RangeMin(const SparseTable &table, size_t first, size_t last) const;
+
+    // First sample from start on at or above, or below, the threshold
+    size_t FirstAtOrAbove(const SparseTable &table, size_t start, float threshold) const;
+    size_t FirstBelow(const SparseTable &table, size_t start, float threshold) const;
+
+    float CrossingTime(int ch, size_t i, float threshold) const;
+
+public:
+    TrajectoryIndex(const TrajectoryRecorder &_output);
+
+    size_t Size() const;
+
+    // Last sample at or before t, the first sample before the recording
+    size_t Find(float t) const;
+
+    // Channel value at t, held at the end values outside the recording
+    float At(int ch, float t) const;
+    // Every subscribed channel at t
+    SimSample StateAt(float t) const;
+
+    // First time after t_start the channel rises through, or falls through,
+    // the threshold. NAN if it never does.
+    float FirstCrossing(int ch, float threshold, bool rising, float t_start = -INFINITY) const;
+
+    // Extremes over the window from t0 to t1
+    float Max(int ch, float t0, float t1) const;
+    float Min(int ch, float t0, float t1) const;
+
+    ~TrajectoryIndex();
+};
+
+#endif
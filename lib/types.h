@@ -23,6 +23,8 @@
 
 #include <string>
 #include <vector>
+#include <stdint.h>
+#include <math.h>
 #include "../include/Eigen/Dense"
 
 // Constant parameters
@@ -47,12 +49,15 @@ inline std::vector<float> tb = {288.15f, 216.85f, 216.85f, 228.65f, 270.65f, 270
 // Layer lapse rates
 inline std::vector<float> lm = {-0.0065f, 0.0f, 0.001f, 0.0028f, 0.0f, -0.0028f, -0.002f};
 
-struct TempFunction
+template <typename T>
+struct TempFunctionT
 {
-    float temp;
+    T temp;
     float b;
 };
 
+typedef TempFunctionT<float> TempFunction;
+
 struct EngineParameters
 {
     std::string type;
@@ -97,22 +102,127 @@ struct EnvironmentParameters
     float gas_constant;
     float air_gamma;
     float atmo_pressure;
+    float wind_speed = 0.0f; // At the 10 m reference height, positive downrange
+    float wind_exponent = 0.143f; // Power law wind profile
+    float launch_angle = 0.0f; // Rail angle from vertical towards downrange, degrees
+};
+
+struct RecoveryParameters
+{
+    float drogue_cd = 0.0f;
+    float drogue_area = 0.0f;
+    float drogue_delay = 0.0f; // After apogee
+    float main_cd = 0.0f;
+    float main_area = 0.0f;
+    float main_altitude = 0.0f; // Above ground level
+};
+
+struct DeadbandParameter
+{
+    std::string channel;
+    float threshold;
+};
+
+struct RecordingParameters
+{
+    float interval = 0.0f; // Decimation interval, zero disables
+    std::vector<DeadbandParameter> deadband;
+    float event_window_before = 0.0f;
+    float event_window_after = 0.0f;
+};
+
+struct CsvPrecisionParameter
+{
+    std::string channel;
+    int digits;
 };
 
 struct SimulationParameters
 {
     std::string logFilename;
     std::string csvFilename;
+    std::string trajectoryFilename;
+    bool compressTrajectory = false; // Delta and XOR encoded blocks in the trajectory file
+    std::vector<CsvPrecisionParameter> csvPrecision; // Significant digits, shortest round trip otherwise
+    float outputStep = 0.0f; // Log interval, zero logs every integration step
+    std::vector<std::string> channels; // Recorded channel names, empty records all
+    float coastDynamicPressure = 0.0f; // Ballistic coast below this, zero disables
+    float coastStep = 1.0f;
+    float descentMaxDrop = 0.0f; // Altitude per quasi-steady descent step, zero disables
+    float descentTolerance = 0.01f; // Relative distance from terminal velocity
+    bool streamOutput = false;      // Write the CSV during the run rather than keeping the trajectory
+    bool recordOutput = true;       // Keep the trajectory, otherwise only the flight summary
+    bool printSummary = true;       // Print the flight summary at the end of the run
 };
 
 // Stores environment variables
-struct EnvironmentVars
+template <typename T>
+struct EnvironmentVarsT
 {
-    float g;
-    TempFunction tempFunc;
-    float pressure;
-    float density;
-    float c;
+    T g;
+    TempFunctionT<T> tempFunc;
+    T pressure;
+    T density;
+    T c;
+};
+
+typedef EnvironmentVarsT<float> EnvironmentVars;
+
+// How the points of a dispersion campaign cover the input space
+enum SamplerType
+{
+    SAMPLER_RANDOM,
+    SAMPLER_SOBOL,
+    SAMPLER_LATIN_HYPERCUBE
+};
+
+// Monte Carlo campaign, each dispersion a standard deviation about the base value
+struct MonteCarloParameters
+{
+    int runs = 0;
+    uint32_t seed = 1;
+    int threads = 0; // Zero uses every core
+    float cd_sigma = 0.0f; // Relative
+    float dry_mass_sigma = 0.0f; // kg
+    float thrust_scale_sigma = 0.0f; // Relative
+    float wind_speed_sigma = 0.0f; // m/s
+    float launch_angle_sigma = 0.0f; // degrees
+    SamplerType sampler = SAMPLER_RANDOM;
+    float tolerance = 0.0f; // Change between checkpoints, relative to the spread, at which to stop. Zero runs them all
+};
+
+// Impact corridor and the importance sampling used to estimate the chance of landing outside it
+struct RangeSafetyParameters
+{
+    float min_downrange = -INFINITY; // m
+    float max_downrange = INFINITY; // m
+    int stage_runs = 1000; // Runs per cross-entropy stage
+    int final_runs = 2000; // Runs of the final estimate
+    int max_stages = 10;
+    float elite_fraction = 0.1f; // Share of each stage the next one is fitted to
+};
+
+struct EnvelopeChannelParameter
+{
+    std::string channel;
+    float min;
+    float max;
+};
+
+// Percentile envelopes of a campaign, one histogram per channel and time bucket
+struct EnvelopeParameters
+{
+    float interval = 1.0f; // s, between time buckets
+    float duration = 600.0f; // s, later samples are dropped
+    int bins = 512; // Per channel, across its range
+    std::vector<EnvelopeChannelParameter> channels;
+};
+
+// On-disk store of finished runs, keyed by a hash of everything that determines them
+struct CacheParameters
+{
+    std::string directory; // Empty disables the cache, as do unversioned or dirty builds
+    float max_size = 256.0f; // MB, least recently used entries are evicted beyond it
 };
 
 struct Params
@@ -124,8 +234,14 @@ struct Params
     Eigen::Vector3f cop;
     Eigen::Vector3f moi;
     AerodynamicsParameters aero;
+    RecoveryParameters recovery;
     EnvironmentParameters env;
     SimulationParameters sim;
+    RecordingParameters recording;
+    MonteCarloParameters monte_carlo;
+    RangeSafetyParameters range_safety;
+    CacheParameters cache;
+    EnvelopeParameters envelope;
 };
 
 struct ThrustCurve
@@ -134,23 +250,54 @@ struct ThrustCurve
     std::vector<float> thrust_curve_y;
 };
 
-struct SimOutput
+enum FlightEventType
+{
+    EVENT_IGNITION,
+    EVENT_BURNOUT,
+    EVENT_APOGEE,
+    EVENT_DROGUE_DEPLOY,
+    EVENT_MAIN_DEPLOY,
+    EVENT_LANDING
+};
+
+struct FlightEvent
+{
+    FlightEventType type;
+    float t;
+};
+
+// Built-in output channels, further channels are registered at runtime
+enum Channel
+{
+    CH_T,
+    CH_ASL,
+    CH_VEL,
+    CH_VEL_MACH,
+    CH_ACC,
+    CH_MASS,
+    CH_MASS_FLOW_RATE,
+    CH_PROP_MASS,
+    CH_THRUST,
+    CH_TWR,
+    CH_DRAG,
+    CH_RHO,
+    CH_PRESSURE,
+    CH_TEMP,
+    CH_G,
+    CH_DOWNRANGE,
+    CH_COUNT
+};
+
+// Upper bound on built-in and registered channels together
+const int max_channels = 32;
+
+// Vehicle and environment state at a single instant, indexed by channel
+struct SimSample
 {
-    std::vector<float> vec_asl;
-    std::vector<float> vec_vel;
-    std::vector<float> vec_vel_mach;
-    std::vector<float> vec_acc;
-    std::vector<float> vec_mass;
-    std::vector<float> vec_mass_flow_rate;
-    std::vector<float> vec_prop_mass;
-    std::vector<float> vec_thrust;
-    std::vector<float> vec_twr;
-    std::vector<float> vec_drag;
-    std::vector<float> vec_rho;
-    std::vector<float> vec_pressure;
-    std::vector<float> vec_temp;
-    std::vector<float> vec_g;
-    std::vector<float> vec_t;
+    float values[max_channels] = {};
+
+    float &operator[](int ch) { return values[ch]; }
+    float operator[](int ch) const { return values[ch]; }
 };
 
 /*
@@ -169,10 +316,15 @@ inline float Clamp(float x, float upper, float lower)
     return fmin(upper, fmax(x, lower));
 }
 
-inline float CalcMaximum(std::vector<float> vec)
+inline float CalcMaximum(const std::vector<float> &vec)
 {
+    if (vec.empty())
+    {
+        return 0;
+    }
+
     float max = vec[0];
-    for (int i = 1; i < vec.size(); i++)
+    for (size_t i = 1; i < vec.size(); i++)
     {
         if (vec[i] > max)
         {
@@ -183,10 +335,15 @@ inline float CalcMaximum(std::vector<float> vec)
     return max;
 }
 
-inline float CalcMinimum(std::vector<float> vec)
+inline float CalcMinimum(const std::vector<float> &vec)
 {
+    if (vec.empty())
+    {
+        return 0;
+    }
+
     float min = vec[0];
-    for (int i = 1; i < vec.size(); i++)
+    for (size_t i = 1; i < vec.size(); i++)
     {
         if (vec[i] < min)
         {
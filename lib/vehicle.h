@@ -0,0 +1,258 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+#ifndef VEHICLE_H_
+#define VEHICLE_H_
+
+#include <math.h>
+#include <algorithm>
+#include "types.h"
+#include "environment.h"
+#include "dual.h"
+
+// Translational state of a point mass vehicle, generic over the scalar type
+template <typename T>
+struct PointMassStateT
+{
+    float t;
+    T altitude;
+    T vel;
+    T downrange;
+    T vel_x;
+    T prop_mass;
+};
+
+// Time derivatives of a point mass state, along with the forces behind them
+template <typename T>
+struct PointMassDerivativeT
+{
+    T vel;
+    T acc;
+    T vel_x;
+    T acc_x;
+    T mass_flow_rate;
+    T thrust;
+    T drag;
+    T mass;
+    EnvironmentVarsT<T> vars;
+};
+
+typedef PointMassStateT<float> PointMassState;
+typedef PointMassDerivativeT<float> PointMassDerivative;
+
+/*
+* Advance a state along a derivative by h, used by the integration policies
+*/
+template <typename T>
+inline PointMassStateT<T> Advance(const PointMassStateT<T> &s, const PointMassDerivativeT<T> &d, float h)
+{
+    PointMassStateT<T> out;
+
+    out.t = s.t + h;
+    out.altitude = s.altitude + d.vel * h;
+    out.vel = s.vel + d.acc * h;
+    out.downrange = s.downrange + d.vel_x * h;
+    out.vel_x = s.vel_x + d.acc_x * h;
+    out.prop_mass = s.prop_mass - d.mass_flow_rate * h;
+
+    return out;
+}
+
+/*
+* Burn and coast flight of a single solid motor with no gimbal, launched
+* vertically and drifting with the wind. There is no recovery, so the vehicle
+* falls ballistically after apogee and lands much nearer the pad than System
+* under parachutes. Every quantity the step needs is held by value so the
+* compiler can inline the full derivative. The scalar type may be a Dual
+* number, in which case the public inputs below can be seeded for
+* sensitivity analysis.
+*/
+template <typename T>
+class SingleSolidMotorT
+{
+private:
+    // Engine
+    float isp;
+    float burn_time;
+    float avg_thrust;
+    std::vector<float> thrust_curve_x;
+    std::vector<float> thrust_curve_y;
+
+    // Propellant at nominal thrust, including the unburnt reserve
+    float nominal_prop_mass;
+
+    // Aerodynamics
+    float cs_area;
+
+    // Environment
+    float elevation;
+    float wind_exponent;
+
+public:
+    typedef T Scalar;
+    typedef PointMassStateT<T> State;
+    typedef PointMassDerivativeT<T> Derivative;
+
+    // Motor thrust at nominal scale, shared by every dispersed copy of the vehicle
+    float CalculateThrust(float t) const
+    {
+        if (t < 0 || t >= burn_time)
+        {
+            return 0;
+        }
+
+        if (thrust_curve_x.size() < 2)
+        {
+            return avg_thrust;
+        }
+
+        size_t i = std::upper_bound(thrust_curve_x.begin(), thrust_curve_x.end(), t) - thrust_curve_x.begin();
+
+        if (i == 0)
+        {
+            return thrust_curve_y.front();
+        }
+        else if (i == thrust_curve_x.size())
+        {
+            return thrust_curve_y.back();
+        }
+
+        return Interpolate(thrust_curve_x[i - 1], thrust_curve_x[i], thrust_curve_y[i - 1], thrust_curve_y[i], t);
+    }
+
+    // Inputs
+    T cd;
+    T dry_mass;
+    T thrust_scale;
+    T wind_speed;
+
+    SingleSolidMotorT(Params p, ThrustCurve curve = ThrustCurve())
+    {
+        isp = p.engine.isp;
+        avg_thrust = p.engine.avg_thrust;
+        burn_time = p.engine.burn_time;
+        thrust_curve_x = curve.thrust_curve_x;
+        thrust_curve_y = curve.thrust_curve_y;
+
+        // Propellant sized as in System
+        float avg_mass_flow_rate = (avg_thrust / g_0) / isp;
+        nominal_prop_mass = (avg_mass_flow_rate * burn_time) / (1 - p.fuel.fuelReserve / 100);
+
+        cs_area = p.aero.cs_area;
+        elevation = p.env.elevation;
+        wind_exponent = p.env.wind_exponent;
+
+        cd = p.aero.cd;
+        dry_mass = p.dryMass;
+        thrust_scale = 1.0f;
+        wind_speed = p.env.wind_speed;
+    }
+
+    State InitialState() const
+    {
+        State s;
+
+        s.t = 0.0f;
+        s.altitude = elevation;
+        s.vel = 0.0f;
+        s.downrange = 0.0f;
+        s.vel_x = 0.0f;
+
+        // Scaling thrust at a fixed burn time scales the propellant burnt
+        s.prop_mass = thrust_scale * nominal_prop_mass;
+
+        return s;
+    }
+
+    // Next discontinuity in the derivative after t
+    float NextEvent(float t) const
+    {
+        return t < burn_time ? burn_time : INFINITY;
+    }
+
+    bool Landed(const State &s) const
+    {
+        return s.t > 0 && s.altitude < elevation;
+    }
+
+    float Elevation() const
+    {
+        return elevation;
+    }
+
+    Derivative Evaluate(const State &s) const
+    {
+        Derivative d;
+
+        d.vars = CalculateEnvironmentVariables(s.altitude);
+        d.mass = dry_mass + s.prop_mass;
+        d.thrust = thrust_scale * CalculateThrust(s.t);
+        d.mass_flow_rate = (d.thrust / g_0) / isp;
+
+        T cda = cd * cs_area;
+        T rel_vel = s.vel_x - CalculateWind(s.altitude - elevation, wind_speed, wind_exponent);
+        T airspeed = sqrt(rel_vel * rel_vel + s.vel * s.vel);
+
+        d.drag = 0.5f * d.vars.density * s.vel * fabs(s.vel) * cda;
+        d.vel = s.vel;
+        d.acc = (d.thrust - d.mass * d.vars.g - d.drag) / d.mass;
+        d.vel_x = s.vel_x;
+        d.acc_x = -0.5f * d.vars.density * airspeed * rel_vel * cda / d.mass;
+
+        // Held on the pad until thrust exceeds weight
+        if (s.t < burn_time && s.altitude <= elevation && s.vel <= 0 && d.acc < 0)
+        {
+            d.acc = 0.0f;
+            d.acc_x = 0.0f;
+        }
+
+        return d;
+    }
+
+    SimSample Sample(const State &s, const Derivative &d) const
+    {
+        SimSample sample;
+
+        sample[CH_T] = s.t;
+        sample[CH_ASL] = Value(s.altitude);
+        sample[CH_VEL] = Value(s.vel);
+        sample[CH_VEL_MACH] = Value(s.vel / d.vars.c);
+        sample[CH_ACC] = Value(d.acc);
+        sample[CH_MASS] = Value(d.mass);
+        sample[CH_MASS_FLOW_RATE] = Value(d.mass_flow_rate);
+        sample[CH_PROP_MASS] = Value(s.prop_mass);
+        sample[CH_THRUST] = Value(d.thrust);
+        sample[CH_TWR] = Value(d.thrust / (d.mass * d.vars.g));
+        sample[CH_DRAG] = Value(d.drag);
+        sample[CH_RHO] = Value(d.vars.density);
+        sample[CH_PRESSURE] = Value(d.vars.pressure);
+        sample[CH_TEMP] = Value(d.vars.tempFunc.temp);
+        sample[CH_G] = Value(d.vars.g);
+        sample[CH_DOWNRANGE] = Value(s.downrange);
+
+        return sample;
+    }
+};
+
+typedef SingleSolidMotorT<float> SingleSolidMotor;
+
+#endif
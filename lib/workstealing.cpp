@@ -0,0 +1,231 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#include "workstealing.h"
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <time.h>
+
+// Set on each worker thread as it starts
+static thread_local size_t current_worker = 0;
+
+static double ThreadCpuTime()
+{
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+WorkStealingScheduler::WorkStealingScheduler(size_t num_threads)
+{
+    if (num_threads == 0)
+    {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < num_threads; i++)
+    {
+        workers.emplace_back(new Worker());
+        workers[i]->busy = 0.0;
+        workers[i]->steals = 0;
+    }
+
+    remaining = 0;
+    next_worker = 0;
+    wall_time = 0.0;
+}
+
+size_t WorkStealingScheduler::NumThreads() const
+{
+    return workers.size();
+}
+
+void WorkStealingScheduler::Submit(Job job)
+{
+    Worker &worker = *workers[next_worker];
+    next_worker = (next_worker + 1) % workers.size();
+
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    worker.jobs.push_back(job);
+    remaining++;
+}
+
+bool WorkStealingScheduler::Pop(size_t index, Job &job)
+{
+    Worker &worker = *workers[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+
+    if (worker.jobs.empty())
+    {
+        return false;
+    }
+
+    job = std::move(worker.jobs.back());
+    worker.jobs.pop_back();
+
+    return true;
+}
+
+bool WorkStealingScheduler::Steal(size_t index, Job &job)
+{
+    Worker &thief = *workers[index];
+
+    for (size_t k = 1; k < workers.size(); k++)
+    {
+        Worker &victim = *workers[(index + k) % workers.size()];
+        std::deque<Job> stolen;
+
+        {
+            std::lock_guard<std::mutex> lock(victim.mutex);
+
+            // Half the victim's jobs, oldest first, rounded up
+            size_t n = (victim.jobs.size() + 1) / 2;
+            for (size_t i = 0; i < n; i++)
+            {
+                stolen.push_back(std::move(victim.jobs.front()));
+                victim.jobs.pop_front();
+            }
+        }
+
+        if (stolen.empty())
+        {
+            continue;
+        }
+
+        job = std::move(stolen.front());
+        stolen.pop_front();
+
+        std::lock_guard<std::mutex> lock(thief.mutex);
+        for (size_t i = 0; i < stolen.size(); i++)
+        {
+            thief.jobs.push_back(std::move(stolen[i]));
+        }
+        thief.steals++;
+
+        return true;
+    }
+
+    return false;
+}
+
+void WorkStealingScheduler::Work(size_t index)
+{
+    Worker &worker = *workers[index];
+    int idle = 0;
+
+    current_worker = index;
+
+    while (remaining > 0)
+    {
+        Job job;
+
+        if (!Pop(index, job) && !Steal(index, job))
+        {
+            // Back off once it is clear there is nothing to steal
+            if (++idle < 64)
+            {
+                std::this_thread::yield();
+            }
+            else
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+            }
+            continue;
+        }
+
+        idle = 0;
+
+        double start = ThreadCpuTime();
+        bool more = job();
+        worker.busy += ThreadCpuTime() - start;
+
+        if (more)
+        {
+            std::lock_guard<std::mutex> lock(worker.mutex);
+            worker.jobs.push_back(std::move(job));
+        }
+        else
+        {
+            remaining--;
+        }
+    }
+}
+
+void WorkStealingScheduler::Run()
+{
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        workers[i]->busy = 0.0;
+        workers[i]->steals = 0;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        threads.emplace_back(&WorkStealingScheduler::Work, this, i);
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    wall_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+size_t WorkStealingScheduler::CurrentWorker()
+{
+    return current_worker;
+}
+
+double WorkStealingScheduler::Utilisation() const
+{
+    double busy = 0.0;
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        busy += workers[i]->busy;
+    }
+
+    return wall_time > 0 ? busy / (wall_time * workers.size()) : 0.0;
+}
+
+size_t WorkStealingScheduler::Steals() const
+{
+    size_t steals = 0;
+
+    for (size_t i = 0; i < workers.size(); i++)
+    {
+        steals += workers[i]->steals;
+    }
+
+    return steals;
+}
+
+WorkStealingScheduler::~WorkStealingScheduler()
+{
+}
@@ -0,0 +1,92 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+#ifndef WORKSTEALING_H_
+#define WORKSTEALING_H_
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/*
+* Job scheduler for batches of simulations of uneven length. Each worker
+* takes jobs from the back of its own deque, and when that is empty steals
+* half of another worker's jobs from the front, so workers that finish early
+* take work from the busy ones rather than sitting idle.
+*
+* A job runs to its next checkpoint and returns true if there is more to do.
+* It then goes back on its worker's deque, where another worker can pick it
+* up if this one moves on to other work.
+*/
+class WorkStealingScheduler
+{
+public:
+    typedef std::function<bool()> Job;
+
+private:
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<Job> jobs;
+
+        // Thread CPU time spent in jobs, and jobs taken from other workers
+        double busy;
+        size_t steals;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic<size_t> remaining;
+    size_t next_worker;
+
+    double wall_time;
+
+    void Work(size_t index);
+    bool Pop(size_t index, Job &job);
+    bool Steal(size_t index, Job &job);
+
+public:
+    // Zero threads uses every core
+    WorkStealingScheduler(size_t num_threads = 0);
+
+    size_t NumThreads() const;
+
+    // Jobs are dealt to the workers in turn
+    void Submit(Job job);
+
+    // Run every submitted job to completion
+    void Run();
+
+    // Fraction of worker time spent in jobs over the last Run
+    double Utilisation() const;
+    size_t Steals() const;
+
+    // Worker running the calling job, for state kept per worker
+    static size_t CurrentWorker();
+
+    ~WorkStealingScheduler();
+};
+
+#endif
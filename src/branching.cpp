@@ -0,0 +1,104 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Recovery dispersions continued from a shared ascent, against full runs.
+*
+* Usage: branching [branches] [threads]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <stdlib.h>
+#include <math.h>
+#include "../lib/fileio.h"
+#include "../lib/branching.h"
+#include "../lib/counterrng.h"
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    parameters.sim.recordOutput = false;
+    parameters.sim.streamOutput = false;
+    parameters.sim.printSummary = false;
+
+    int n = argc > 1 ? atoi(argv[1]) : 200;
+    int threads = argc > 2 ? atoi(argv[2]) : parameters.monte_carlo.threads;
+
+    // Parachute drag, deployment delay and main altitude only act after apogee
+    CounterRng rng(parameters.monte_carlo.seed);
+    std::vector<Params> branches(n, parameters);
+
+    for (int i = 0; i < n; i++)
+    {
+        RecoveryParameters &r = branches[i].recovery;
+
+        r.drogue_cd *= 1.0f + 0.1f * rng.Normal(0, i);
+        r.main_cd *= 1.0f + 0.1f * rng.Normal(1, i);
+        r.drogue_delay = fmax(r.drogue_delay + 0.5f * rng.Normal(2, i), 0.0f);
+        r.main_altitude = fmax(r.main_altitude + 50.0f * rng.Normal(3, i), 0.0f);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    TrajectoryBranching branching(parameters);
+
+    if (!branching.Fork(EVENT_APOGEE))
+    {
+        std::cout << "Flight landed before apogee" << std::endl;
+        return 1;
+    }
+
+    std::vector<FlightSummary> summaries = branching.Continue(branches, threads);
+    double branch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Fork at t = " << branching.Snapshot().t << " s, " << branching.Snapshot().asl << " m" << std::endl;
+    std::cout << "Branches: " << n << " in " << branch_seconds << " s" << std::endl;
+
+    // The same flights from ignition
+    start = std::chrono::steady_clock::now();
+
+    float max_time_diff = 0.0f;
+    float max_downrange_diff = 0.0f;
+
+    for (int i = 0; i < n; i++)
+    {
+        System s(branches[i]);
+        s.RunSimulation();
+
+        max_time_diff = fmax(max_time_diff, fabs(s.summary.impact_time - summaries[i].impact_time));
+        max_downrange_diff = fmax(max_downrange_diff, fabs(s.summary.impact_downrange - summaries[i].impact_downrange));
+    }
+
+    double full_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "Full runs: " << n << " in " << full_seconds << " s" << std::endl;
+    std::cout << "Speed-up: " << full_seconds / branch_seconds << "x" << std::endl;
+    std::cout << "Max difference: impact time " << max_time_diff << " s, downrange " << max_downrange_diff << " m" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+/*
+* Benchmark of CSV output, comparing the stream based writer the
+* simulation used to have with CsvWriter. Runs on a recorded trajectory
+* file, repeated up to the row count, or on synthetic data without one.
+*
+* Usage: csvbenchmark [rows] [trajectory file]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lib/csvwriter.h"
+#include "../lib/trajectoryfile.h"
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+int main(int argc, char **argv)
+{
+    size_t rows = argc > 1 ? atol(argv[1]) : 200000;
+    std::string filename = "csv_benchmark.csv";
+
+    size_t num_columns = 17;
+    std::vector<std::string> names;
+    std::vector<float> data;
+
+    TrajectoryFile trajectory;
+    if (argc > 2)
+    {
+        if (!trajectory.Open(argv[2]) || trajectory.NumSamples() == 0)
+        {
+            return 1;
+        }
+
+        num_columns = trajectory.NumColumns();
+        data.resize(rows * num_columns);
+
+        for (size_t c = 0; c < num_columns; c++)
+        {
+            names.push_back(trajectory.ColumnName(c));
+
+            for (size_t i = 0; i < rows; i++)
+            {
+                data[i * num_columns + c] = trajectory.Column(c)[i % trajectory.NumSamples()];
+            }
+        }
+    }
+    else
+    {
+        // Smoothly varying values with a spread of magnitudes
+        data.resize(rows * num_columns);
+
+        for (size_t c = 0; c < num_columns; c++)
+        {
+            names.push_back("Channel" + std::to_string(c));
+
+            for (size_t i = 0; i < rows; i++)
+            {
+                data[i * num_columns + c] = (float)(sin(i * 1e-3 + c) * pow(10.0, (int)c % 7 - 2));
+            }
+        }
+    }
+
+    // operator<< per value and std::endl per row
+    auto start = std::chrono::steady_clock::now();
+    {
+        std::ofstream file(filename);
+
+        for (size_t c = 0; c < num_columns; c++)
+        {
+            file << names[c] << ",";
+        }
+        file << std::endl;
+
+        for (size_t i = 0; i < rows; i++)
+        {
+            for (size_t c = 0; c < num_columns; c++)
+            {
+                file << data[i * num_columns + c] << ",";
+            }
+            file << std::endl;
+        }
+    }
+    double stream_time = Seconds(start);
+
+    start = std::chrono::steady_clock::now();
+    {
+        CsvWriter csv;
+        csv.Open(filename);
+        csv.WriteHeader(names);
+
+        for (size_t i = 0; i < rows; i++)
+        {
+            csv.WriteRow(&data[i * num_columns]);
+        }
+    }
+    double csv_time = Seconds(start);
+
+    std::cout << rows << " rows of " << num_columns << " columns" << std::endl;
+    std::cout << "ostream:   " << rows / stream_time << " rows/s" << std::endl;
+    std::cout << "CsvWriter: " << rows / csv_time << " rows/s" << std::endl;
+    std::cout << "Speedup:   " << stream_time / csv_time << "x" << std::endl;
+
+    remove(filename.c_str());
+
+    return 0;
+}
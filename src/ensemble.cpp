@@ -0,0 +1,149 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Run a dispersed ensemble of single motor vehicles in lockstep and against
+* the same vehicles run one at a time, reporting the agreement and speed up.
+* The nominal vehicle is also flown with the Euler update System uses, to
+* show the integration error RK4 removes.
+*
+* Usage: ensemble [vehicles]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <stdlib.h>
+#include "../lib/fileio.h"
+#include "../lib/ensemble.h"
+#include "../lib/simulator.h"
+#include "../lib/sampling.h"
+#include "../lib/montecarlo.h"
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params p = parser.ParseRocketConfig("include/rocket.xml");
+    ThrustCurve curve = parser.ParseThrustCurve("include/Cesaroni_O8000.xml");
+    const MonteCarloParameters &mc = p.monte_carlo;
+
+    int n = argc > 1 ? atoi(argv[1]) : 4096;
+
+    SingleSolidMotorEnsemble ensemble(p, curve, n);
+
+    // Deviates from the campaign's sampler
+    DispersionSampler sampler(mc.sampler, mc.seed, DISP_COUNT, n);
+    EnsembleArray z[DISP_COUNT];
+
+    for (int k = 0; k < DISP_COUNT; k++)
+    {
+        z[k].resize(n);
+        sampler.Normals(k, 0, n, z[k].data());
+    }
+
+    ensemble.cd = p.aero.cd * (1.0f + mc.cd_sigma * z[DISP_CD]).max(0.01f);
+    ensemble.dry_mass = (p.dryMass + mc.dry_mass_sigma * z[DISP_DRY_MASS]).max(0.01f * p.dryMass);
+    ensemble.thrust_scale = (1.0f + mc.thrust_scale_sigma * z[DISP_THRUST_SCALE]).max(0.01f);
+    ensemble.wind_speed = p.env.wind_speed + mc.wind_speed_sigma * z[DISP_WIND_SPEED];
+
+    EnsembleSimulator<SingleSolidMotorEnsemble, RK4> sim(ensemble, p.env.dt);
+
+    auto start = std::chrono::steady_clock::now();
+    sim.RunSimulation();
+    double ensemble_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<FlightSummary> scalar(n);
+
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < n; i++)
+    {
+        SingleSolidMotor vehicle(p, curve);
+        vehicle.cd = ensemble.cd[i];
+        vehicle.dry_mass = ensemble.dry_mass[i];
+        vehicle.thrust_scale = ensemble.thrust_scale[i];
+        vehicle.wind_speed = ensemble.wind_speed[i];
+
+        FlightSummary &summary = scalar[i];
+        PointMassState last;
+
+        auto track = [&](const PointMassState &s, const PointMassDerivative &d)
+        {
+            summary.Update(vehicle.Sample(s, d));
+            last = s;
+        };
+
+        Simulator<SingleSolidMotor, RK4> single(vehicle, p.env.dt);
+        single.Propagate(track);
+
+        summary.landed = true;
+        summary.impact_time = last.t;
+        summary.impact_downrange = last.downrange;
+    }
+    double scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    float apogee_error = 0.0f;
+    float downrange_error = 0.0f;
+    float time_error = 0.0f;
+
+    for (int i = 0; i < n; i++)
+    {
+        const FlightSummary &a = sim.Summaries()[i];
+        const FlightSummary &b = scalar[i];
+
+        apogee_error = fmax(apogee_error, fabs(a.apogee.value - b.apogee.value));
+        downrange_error = fmax(downrange_error, fabs(a.impact_downrange - b.impact_downrange));
+        time_error = fmax(time_error, fabs(a.impact_time - b.impact_time));
+    }
+
+    std::cout << "Vehicles: " << n << std::endl;
+    std::cout << "Ensemble: " << ensemble_seconds << " s, " << n / ensemble_seconds << " vehicles/s" << std::endl;
+    std::cout << "Scalar: " << scalar_seconds << " s, " << n / scalar_seconds << " vehicles/s" << std::endl;
+    std::cout << "Speed up: " << scalar_seconds / ensemble_seconds << "x" << std::endl;
+    std::cout << "Max difference: apogee " << apogee_error << " m, impact " << downrange_error << " m downrange, "
+              << time_error << " s" << std::endl;
+
+    // Nominal apogee under each integration policy
+    SingleSolidMotor nominal(p, curve);
+    float apogee_rk4 = 0.0f;
+    float apogee_euler = 0.0f;
+
+    auto track_rk4 = [&](const PointMassState &s, const PointMassDerivative &)
+    {
+        apogee_rk4 = fmax(apogee_rk4, s.altitude);
+    };
+
+    auto track_euler = [&](const PointMassState &s, const PointMassDerivative &)
+    {
+        apogee_euler = fmax(apogee_euler, s.altitude);
+    };
+
+    Simulator<SingleSolidMotor, RK4> rk4(nominal, p.env.dt);
+    rk4.Propagate(track_rk4);
+
+    Simulator<SingleSolidMotor, Euler> euler(nominal, p.env.dt);
+    euler.Propagate(track_euler);
+
+    std::cout << "Nominal apogee: RK4 " << apogee_rk4 << " m, Euler " << apogee_euler << " m" << std::endl;
+
+    return 0;
+}
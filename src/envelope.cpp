@@ -0,0 +1,113 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Percentile envelopes of altitude, velocity and Mach across a dispersion
+* campaign, written to Envelope.csv.
+*
+* Usage: envelope [runs] [threads]
+*/
+
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <vector>
+#include <stdlib.h>
+#include "../lib/fileio.h"
+#include "../lib/envelope.h"
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    if (argc > 1)
+    {
+        parameters.monte_carlo.runs = atoi(argv[1]);
+    }
+
+    if (argc > 2)
+    {
+        parameters.monte_carlo.threads = atoi(argv[2]);
+    }
+
+    const MonteCarloParameters &mc = parameters.monte_carlo;
+    int n = std::max(mc.runs, 0);
+
+    DispersionSampler sampler(mc.sampler, mc.seed, DISP_COUNT, n);
+    std::vector<MonteCarloRun> runs(n);
+    std::vector<float> z(n);
+
+    for (int k = 0; k < DISP_COUNT; k++)
+    {
+        sampler.Normals(k, 0, n, z.data());
+
+        for (int i = 0; i < n; i++)
+        {
+            runs[i].z[k] = z[i];
+        }
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    EnvelopeAggregator envelope = SimulateEnvelope(parameters, mc.threads, runs.data(), n);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const std::vector<int> &channels = envelope.Channels();
+    std::ofstream file("Envelope.csv");
+
+    file << "Time,Runs";
+    for (size_t c = 0; c < channels.size(); c++)
+    {
+        std::string name = GetChannelInfo(channels[c]).name;
+        file << "," << name << "_p05," << name << "_p50," << name << "_p95";
+    }
+    file << std::endl;
+
+    for (size_t b = 0; b < envelope.NumBuckets(); b++)
+    {
+        if (channels.empty() || envelope.Histogram(b, 0).Count() == 0)
+        {
+            continue;
+        }
+
+        file << envelope.BucketTime(b) << "," << envelope.Histogram(b, 0).Count();
+
+        for (size_t c = 0; c < channels.size(); c++)
+        {
+            const StreamingHistogram &h = envelope.Histogram(b, c);
+            file << "," << h.Quantile(0.05f) << "," << h.Quantile(0.5f) << "," << h.Quantile(0.95f);
+        }
+        file << std::endl;
+    }
+
+    // Every sample of every run at the bucket interval, for comparison
+    double stored = (double)n * envelope.NumBuckets() * (channels.size() + 1) * sizeof(float);
+
+    std::cout << "Runs: " << n << " in " << seconds << " s" << std::endl;
+    std::cout << "Envelope memory: " << envelope.MemoryUsage() / 1048576.0 << " MB, against "
+              << stored / 1048576.0 << " MB for the trajectories" << std::endl;
+    std::cout << "Envelope written to Envelope.csv" << std::endl;
+
+    return 0;
+}
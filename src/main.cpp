@@ -23,6 +23,7 @@
 #include "../lib/parameters.h"
 #include "../lib/system.h"
 #include "../lib/fileio.h"
+#include "../lib/plotting.h"
 
 float burn_time;
 
@@ -58,7 +59,11 @@ int main()
 
     //s.RunSimulation();
 
+    //PlotTrajectory(s.output);
+
     //parser.WriteOutput(s, parameters.sim.csvFilename);
 
+    //parser.WriteBinaryOutput(s, parameters.sim.trajectoryFilename);
+
     //std::cin.get();
 }
\ No newline at end of file
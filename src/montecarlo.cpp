@@ -0,0 +1,85 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+/*
+* Run the Monte Carlo campaign described in the rocket configuration.
+*
+* Usage: montecarlo [runs] [threads]
+*        montecarlo replay <run>
+*/
+
+#include <iostream>
+#include <chrono>
+#include <stdlib.h>
+#include <string.h>
+#include "../lib/fileio.h"
+#include "../lib/montecarlo.h"
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    // Regenerate one run of the campaign without the runs before it
+    if (argc > 2 && strcmp(argv[1], "replay") == 0)
+    {
+        int index = atoi(argv[2]);
+        MonteCarloRun run = MonteCarloRunner(parameters).Replay(index);
+
+        std::cout << "Run " << index << std::endl;
+
+        for (int k = 0; k < DISP_COUNT; k++)
+        {
+            std::cout << DispersionName(k) << ": z " << run.z[k] << std::endl;
+        }
+
+        for (int k = 0; k < MC_OUTPUT_COUNT; k++)
+        {
+            std::cout << MonteCarloOutputName(k) << ": " << MonteCarloOutputValue(run.summary, k) << std::endl;
+        }
+
+        return 0;
+    }
+
+    if (argc > 1)
+    {
+        parameters.monte_carlo.runs = atoi(argv[1]);
+    }
+
+    if (argc > 2)
+    {
+        parameters.monte_carlo.threads = atoi(argv[2]);
+    }
+
+    MonteCarloRunner runner(parameters);
+
+    auto start = std::chrono::steady_clock::now();
+    runner.Run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    runner.PrintSummary();
+    std::cout << "Throughput: " << runner.Runs().size() / seconds << " runs/s" << std::endl;
+    std::cout << "Utilisation: " << 100.0 * runner.Utilisation() << "%" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,101 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Estimate the probability of landing outside the range safety corridor.
+*
+* Usage: rangesafety [max_downrange] [runs]
+*
+* With a run count the estimate is checked against that many plain
+* Monte Carlo runs, which only resolves probabilities above about 10/runs.
+*/
+
+#include <iostream>
+#include <chrono>
+#include <vector>
+#include <stdlib.h>
+#include "../lib/fileio.h"
+#include "../lib/rangesafety.h"
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    if (argc > 1)
+    {
+        parameters.range_safety.max_downrange = atof(argv[1]);
+    }
+
+    std::cout << "Corridor: " << parameters.range_safety.min_downrange << " m to " << parameters.range_safety.max_downrange << " m" << std::endl;
+
+    RangeSafetyAnalysis analysis(parameters);
+
+    auto start = std::chrono::steady_clock::now();
+    RangeSafetyResult result = analysis.Run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    RangeSafetyAnalysis::PrintResult(result);
+
+    int total_runs = 0;
+    for (int edge = 0; edge < EDGE_COUNT; edge++)
+    {
+        const RangeSafetyEdgeResult &r = result.edges[edge];
+
+        total_runs += r.runs;
+        for (size_t i = 0; i < r.stages.size(); i++)
+        {
+            total_runs += r.stages[i].runs;
+        }
+    }
+
+    std::cout << "Total runs: " << total_runs << " in " << seconds << " s" << std::endl;
+
+    if (argc > 2)
+    {
+        int n = atoi(argv[2]);
+        std::vector<MonteCarloRun> runs(n);
+
+        for (int i = 0; i < n; i++)
+        {
+            DrawDeviates(parameters.monte_carlo, i, runs[i].z);
+        }
+
+        SimulateRuns(parameters, parameters.monte_carlo.threads, runs.data(), n);
+
+        int violations = 0;
+        for (int i = 0; i < n; i++)
+        {
+            if (RangeSafetyMargin(parameters.range_safety, runs[i].summary) > 0)
+            {
+                violations++;
+            }
+        }
+
+        double p = (double)violations / n;
+        std::cout << "Plain Monte Carlo: " << violations << " of " << n << " runs, probability " << p << " +/- " << sqrt(p * (1 - p) / n) << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,159 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Check the result cache on the rocket configuration: a stored run is hit,
+* a changed parameter misses, the least recently used entry is evicted
+* once the budget shrinks, and a stored trajectory reads back unchanged.
+* Needs a build with ROCKETSIM_VERSION set from a committed revision.
+*
+* Usage: resultcache [directory]
+*/
+
+#include <iostream>
+#include <filesystem>
+#include "../lib/fileio.h"
+#include "../lib/resultcache.h"
+#include "../lib/trajectoryfile.h"
+
+namespace fs = std::filesystem;
+
+static void Report(const char *check, bool passed, bool &all_passed)
+{
+    std::cout << check << ": " << (passed ? "ok" : "FAILED") << std::endl;
+    all_passed = all_passed && passed;
+}
+
+// Fly and store a run, returning the key it was stored under
+static std::string StoreRun(const ResultCache &cache, const Params &p, System &s)
+{
+    std::string key = ResultCache::Key(p, ThrustCurve());
+
+    s = System(p);
+    s.RunSimulation();
+    cache.Store(key, s);
+
+    return key;
+}
+
+static bool SameTrajectory(const TrajectoryRecorder &output, const std::string &filename)
+{
+    TrajectoryFile file;
+
+    if (!file.Open(filename) || file.NumSamples() != output.Size() || file.NumColumns() != output.ChannelList().size())
+    {
+        return false;
+    }
+
+    for (size_t c = 0; c < file.NumColumns(); c++)
+    {
+        ColumnView column = output.Column(FindChannel(file.ColumnName(c)));
+        const float *stored = file.Column(c);
+
+        if (column.Size() != file.NumSamples())
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < column.Size(); i++)
+        {
+            if (stored[i] != column[i])
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    parameters.cache.directory = argc > 1 ? argv[1] : "ResultCacheCheck";
+    parameters.sim.recordOutput = true;
+    parameters.sim.streamOutput = false;
+    parameters.sim.printSummary = false;
+
+    ResultCache cache(parameters.cache);
+
+    if (!cache.Enabled())
+    {
+        std::cout << "Error: Cache disabled, build with -DROCKETSIM_VERSION from a committed revision!" << std::endl;
+        return 1;
+    }
+
+    // Eviction below would otherwise remove someone's entries
+    std::error_code error;
+    if (fs::exists(parameters.cache.directory) && !fs::is_empty(parameters.cache.directory, error))
+    {
+        std::cout << "Error: Cache directory " << parameters.cache.directory << " is not empty!" << std::endl;
+        return 1;
+    }
+
+    bool passed = true;
+    CachedResult result;
+    System s;
+
+    std::string nominal_key = ResultCache::Key(parameters, ThrustCurve());
+    Report("Miss before the first run", !cache.Load(nominal_key, result), passed);
+
+    StoreRun(cache, parameters, s);
+    bool hit = cache.Load(nominal_key, result);
+    Report("Hit after storing", hit, passed);
+    Report("Summary matches the run", hit && result.summary.impact_downrange == s.summary.impact_downrange &&
+           result.summary.impact_time == s.summary.impact_time && result.events.size() == s.events.size(), passed);
+    Report("Trajectory reads back", hit && SameTrajectory(s.output, result.trajectory), passed);
+
+    std::cout << "Impact downrange: " << result.summary.impact_downrange << " m, trajectory " << result.trajectory << std::endl;
+
+    // Any parameter the run depends on gives another entry
+    Params changed = parameters;
+    changed.engine.avg_thrust *= 1.01f;
+
+    std::string changed_key = ResultCache::Key(changed, ThrustCurve());
+    Report("Miss after a parameter change", !cache.Load(changed_key, result), passed);
+
+    StoreRun(cache, changed, s);
+    Report("Hit on the changed run", cache.Load(changed_key, result), passed);
+
+    // Touch the nominal entry, then shrink the budget to about one entry
+    cache.Load(nominal_key, result);
+
+    uintmax_t entry_size = fs::file_size(fs::path(result.trajectory).replace_extension(".res"), error) +
+                           fs::file_size(result.trajectory, error);
+
+    CacheParameters small = parameters.cache;
+    small.max_size = 1.5f * entry_size / (1024.0f * 1024.0f);
+    ResultCache(small).Trim();
+
+    Report("Least recently used entry evicted", !cache.Load(changed_key, result), passed);
+    Report("Recently used entry kept", cache.Load(nominal_key, result), passed);
+
+    std::cout << (passed ? "All checks passed" : "Some checks FAILED") << std::endl;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Print the automatic differentiation gradients of the burn and coast model
+* beside central finite differences of the same model, and the recovered
+* impact System flies to for comparison.
+*
+* Usage: sensitivity [relative step]
+*/
+
+#include <iostream>
+#include <iomanip>
+#include <stdlib.h>
+#include <math.h>
+#include "../lib/fileio.h"
+#include "../lib/sensitivity.h"
+#include "../lib/system.h"
+
+static const char *input_names[SENS_COUNT] = {"Cd", "Dry_mass", "Thrust_scale", "Wind_speed"};
+
+// Params with one input moved by delta, in the input's own units
+static Params Perturb(Params p, int input, float delta)
+{
+    switch (input)
+    {
+    case SENS_CD:
+        p.aero.cd += delta;
+        break;
+    case SENS_DRY_MASS:
+        p.dryMass += delta;
+        break;
+    case SENS_THRUST_SCALE:
+        // Propellant scales with thrust at a fixed burn time, as in the model
+        p.engine.avg_thrust *= 1.0f + delta;
+        break;
+    case SENS_WIND_SPEED:
+        p.env.wind_speed += delta;
+        break;
+    }
+
+    return p;
+}
+
+static float InputValue(const Params &p, int input)
+{
+    switch (input)
+    {
+    case SENS_CD:
+        return p.aero.cd;
+    case SENS_DRY_MASS:
+        return p.dryMass;
+    case SENS_WIND_SPEED:
+        return p.env.wind_speed;
+    default:
+        return 1.0f;
+    }
+}
+
+static const SensitivityValue &Output(const SensitivityResult &r, int k)
+{
+    const SensitivityValue *outputs[] = {&r.apogee, &r.max_q, &r.ballistic_impact_time, &r.ballistic_impact_downrange};
+
+    return *outputs[k];
+}
+
+int main(int argc, char **argv)
+{
+    static const char *output_names[] = {"Apogee", "Max_q", "Ballistic_impact_time", "Ballistic_impact_downrange"};
+    const int num_outputs = 4;
+
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    float step = argc > 1 ? atof(argv[1]) : 1e-2f;
+
+    SensitivityResult nominal = CalculateSensitivities(parameters);
+    SensitivityResult upper[SENS_COUNT];
+    SensitivityResult lower[SENS_COUNT];
+    float delta[SENS_COUNT];
+
+    for (int i = 0; i < SENS_COUNT; i++)
+    {
+        delta[i] = step * fmax(fabs(InputValue(parameters, i)), 1.0f);
+        upper[i] = CalculateSensitivities(Perturb(parameters, i, delta[i]));
+        lower[i] = CalculateSensitivities(Perturb(parameters, i, -delta[i]));
+    }
+
+    std::cout << std::setw(28) << std::left << "Output" << std::setw(14) << "Input" << std::right
+              << std::setw(16) << "Gradient" << std::setw(16) << "Finite diff" << std::setw(12) << "Rel error" << std::endl;
+
+    for (int k = 0; k < num_outputs; k++)
+    {
+        std::cout << output_names[k] << ": " << Output(nominal, k).value << std::endl;
+
+        for (int i = 0; i < SENS_COUNT; i++)
+        {
+            float gradient = Output(nominal, k).gradient[i];
+            float finite = (Output(upper[i], k).value - Output(lower[i], k).value) / (2.0f * delta[i]);
+            float error = fabs(gradient - finite) / fmax(fabs(finite), 1e-6f);
+
+            std::cout << std::setw(28) << std::left << "" << std::setw(14) << input_names[i] << std::right
+                      << std::setw(16) << gradient << std::setw(16) << finite << std::setw(12) << error << std::endl;
+        }
+    }
+
+    // The model has no parachutes, so its impact is not the one System reports
+    parameters.sim.recordOutput = false;
+    parameters.sim.streamOutput = false;
+    parameters.sim.printSummary = false;
+
+    System s(parameters);
+    s.RunSimulation();
+
+    std::cout << "System with recovery: apogee " << s.summary.apogee.value << " m, impact downrange "
+              << s.summary.impact_downrange << " m at " << s.summary.impact_time << " s" << std::endl;
+
+    return 0;
+}
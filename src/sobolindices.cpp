@@ -0,0 +1,63 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+
+/*
+* Sobol sensitivity indices of the campaign outputs to each dispersion.
+*
+* Usage: sobolindices [rows] [threads]
+*/
+
+#include <iostream>
+#include <chrono>
+#include <stdlib.h>
+#include "../lib/fileio.h"
+#include "../lib/sobolindices.h"
+
+int main(int argc, char **argv)
+{
+    FileIO parser;
+    Params parameters = parser.ParseRocketConfig("include/rocket.xml");
+
+    if (argc > 1)
+    {
+        parameters.monte_carlo.runs = atoi(argv[1]);
+    }
+
+    if (argc > 2)
+    {
+        parameters.monte_carlo.threads = atoi(argv[2]);
+    }
+
+    SensitivityAnalysis analysis(parameters);
+
+    auto start = std::chrono::steady_clock::now();
+    analysis.Run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    analysis.PrintSummary();
+    std::cout << "Throughput: " << analysis.Runs() / seconds << " runs/s" << std::endl;
+    std::cout << "Utilisation: " << 100.0 * analysis.Utilisation() << "%" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,109 @@
+/*
+ * RocketSim, a 6DOF simulation platform for launch vehicles.
+ * 
+ * @Author: Matthew Carroll
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * Reach out to the author at the following email address:
+ * matthew99carroll@gmail.com
+ */
+
+
+
+/*
+* Export a binary trajectory file to CSV.
+*
+* Usage: trajectory2csv Flight.trj [Flight.csv]
+*/
+
+#include <iostream>
+#include <vector>
+#include <algorithm>
+#include "../lib/trajectoryfile.h"
+#include "../lib/csvwriter.h"
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <trajectory file> [csv file]" << std::endl;
+        return 1;
+    }
+
+    // Compressed files are decoded a block at a time, plain ones read in place
+    TrajectoryFile trajectory;
+    CompressedTrajectoryFile compressed;
+    bool is_compressed = IsCompressedTrajectoryFile(argv[1]);
+
+    if (is_compressed ? !compressed.Open(argv[1]) : !trajectory.Open(argv[1]))
+    {
+        return 1;
+    }
+
+    CsvWriter csv(std::cout);
+    if (argc > 2 && !csv.Open(argv[2]))
+    {
+        return 1;
+    }
+
+    size_t num_columns = is_compressed ? compressed.NumColumns() : trajectory.NumColumns();
+    size_t num_samples = is_compressed ? compressed.NumSamples() : trajectory.NumSamples();
+    size_t block_size = is_compressed ? compressed.BlockSize() : num_samples;
+
+    std::vector<std::string> names;
+    for (size_t c = 0; c < num_columns; c++)
+    {
+        names.push_back(is_compressed ? compressed.ColumnName(c) : trajectory.ColumnName(c));
+    }
+
+    csv.WriteHeader(names);
+
+    std::vector<std::vector<float>> blocks(num_columns, std::vector<float>(is_compressed ? block_size : 0));
+    std::vector<const float *> columns(num_columns);
+    std::vector<float> row(num_columns);
+
+    for (size_t start = 0; start < num_samples; start += block_size)
+    {
+        for (size_t c = 0; c < num_columns; c++)
+        {
+            if (is_compressed)
+            {
+                if (!compressed.DecodeBlock(c, start / block_size, blocks[c].data()))
+                {
+                    std::cout << "Error: " << argv[1] << " has a corrupt block in column " << names[c] << std::endl;
+                    return 1;
+                }
+                columns[c] = blocks[c].data();
+            }
+            else
+            {
+                columns[c] = trajectory.Column(c);
+            }
+        }
+
+        size_t n = std::min(block_size, num_samples - start);
+        for (size_t i = 0; i < n; i++)
+        {
+            for (size_t c = 0; c < num_columns; c++)
+            {
+                row[c] = columns[c][i];
+            }
+            csv.WriteRow(row.data());
+        }
+    }
+
+    csv.Close();
+
+    return 0;
+}